@@ -23,9 +23,12 @@ int main(int, char *argv[]) {
 
   PetriNet petri(net, "composed_net", pool, initial_marking, goal_marking);
 
-  petri.registerCallback("SingleStepProcessor", Foo{0.75, 3ms});
-  petri.registerCallback("StepOne", Foo{0.75, 1ms});
-  petri.registerCallback("StepTwo", Foo{0.75, 2ms});
+  petri.registerCallback("SingleStepProcessor", Foo{0.75});
+  petri.setDelay("SingleStepProcessor", 3ms);
+  petri.registerCallback("StepOne", Foo{0.75});
+  petri.setDelay("StepOne", 1ms);
+  petri.registerCallback("StepTwo", Foo{0.75});
+  petri.setDelay("StepTwo", 2ms);
 
   auto now = Clock::now();
   auto result = fire(petri);
@@ -19,8 +19,10 @@ int main(int, char *argv[]) {
       {{"TaskBucket", Success}, {"ResourceDualProcessor", Success}},
       {{"SuccessfulTasks", Success}, {"ResourceDualProcessor", Success}});
 
-  child_net.registerCallback("StepOne", Foo{0.75, 1ms});
-  child_net.registerCallback("StepTwo", Foo{0.75, 2ms});
+  child_net.registerCallback("StepOne", Foo{0.75});
+  child_net.setDelay("StepOne", 1ms);
+  child_net.registerCallback("StepTwo", Foo{0.75});
+  child_net.setDelay("StepTwo", 2ms);
 
   // for the parent net:
   const auto read = readPnml({tasks, single_step_processor});
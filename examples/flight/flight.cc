@@ -34,7 +34,7 @@ void resume(const Foo &f) { f.resume(); }
  * @param eventlog
  */
 void printLog(const symmetri::Eventlog &eventlog) {
-  for (const auto &[caseid, t, s, c] : eventlog) {
+  for (const auto &[caseid, t, s, c, instance] : eventlog) {
     std::cout << "Eventlog: " << caseid << ", " << t << ", " << s.toString()
               << ", " << c.time_since_epoch().count() << std::endl;
   }
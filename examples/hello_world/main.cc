@@ -55,9 +55,10 @@ int main(int, char *argv[]) {
                   // the net completes, deadlocks or user requests exit (ctrl-c)
 
   // this simply prints the event log
-  for (const auto &[caseid, t, s, c] : getLog(net)) {
+  for (const auto &[caseid, t, s, c, instance] : getLog(net)) {
     std::cout << "Eventlog: " << caseid << ", " << t << ", " << s.toString()
-              << ", " << c.time_since_epoch().count() << std::endl;
+              << ", " << c.time_since_epoch().count() << ", " << instance
+              << std::endl;
   }
 
   // return the result! If everything went well, you typically return
@@ -0,0 +1,188 @@
+#include <stdint.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "petri.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Compares walking the arcs of a large net stored as a vector of small vectors
+// with walking the same arcs stored in CSR format. Transitions have 8 input
+// arcs, more than the inline capacity of SmallVectorInput, so every row of the
+// vector layout is a separate heap allocation. The rows are visited in random
+// order, like the consumers of the dirty places, and in order. If the kernel
+// allows it, L1 data cache and last level cache misses are counted with
+// perf_event_open.
+using namespace symmetri;
+
+class MissCounter {
+ public:
+  explicit MissCounter(uint32_t type, uint64_t config) {
+#if defined(__linux__)
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd_ = static_cast<int>(
+        syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#else
+    (void)type;
+    (void)config;
+#endif
+  }
+  ~MissCounter() {
+#if defined(__linux__)
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+#endif
+  }
+  bool available() const { return fd_ >= 0; }
+  void start() {
+#if defined(__linux__)
+    if (fd_ >= 0) {
+      ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+  }
+  uint64_t stop() {
+    uint64_t count = 0;
+#if defined(__linux__)
+    if (fd_ >= 0) {
+      ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+      if (read(fd_, &count, sizeof(count)) != sizeof(count)) {
+        count = 0;
+      }
+    }
+#endif
+    return count;
+  }
+
+ private:
+  int fd_ = -1;
+};
+
+struct Result {
+  double ns_per_arc;
+  double l1_misses_per_arc;
+  double llc_misses_per_arc;
+};
+
+template <typename F>
+Result measure(size_t arcs, F&& walk) {
+#if defined(__linux__)
+  MissCounter l1(PERF_TYPE_HW_CACHE,
+                 PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                     (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+  MissCounter llc(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+#else
+  MissCounter l1(0, 0), llc(0, 0);
+#endif
+  constexpr size_t repetitions = 20;
+  uint64_t checksum = 0;
+  l1.start();
+  llc.start();
+  const auto begin = Clock::now();
+  for (size_t i = 0; i < repetitions; i++) {
+    checksum += walk();
+  }
+  const auto end = Clock::now();
+  const auto l1_misses = l1.stop();
+  const auto llc_misses = llc.stop();
+  if (checksum == 0) {
+    std::cerr << "unexpected checksum" << std::endl;
+  }
+  const double total = static_cast<double>(repetitions * arcs);
+  const auto ns = std::chrono::duration<double, std::nano>(end - begin);
+  return {ns.count() / total, l1.available() ? l1_misses / total : -1.0,
+          llc.available() ? llc_misses / total : -1.0};
+}
+
+void print(size_t arcs, const char* layout, const char* order,
+           const Result& r) {
+  std::cout << std::setw(10) << arcs << std::setw(8) << layout
+            << std::setw(10) << order << std::setw(14) << r.ns_per_arc;
+  for (const auto misses : {r.l1_misses_per_arc, r.llc_misses_per_arc}) {
+    if (misses < 0) {
+      std::cout << std::setw(18) << "n/a";
+    } else {
+      std::cout << std::setw(18) << misses;
+    }
+  }
+  std::cout << std::endl;
+}
+
+int main() {
+  std::mt19937 rng(42);
+  std::cout << std::setw(10) << "arcs" << std::setw(8) << "layout"
+            << std::setw(10) << "order" << std::setw(14) << "[ns/arc]"
+            << std::setw(18) << "L1D miss/arc" << std::setw(18)
+            << "LLC miss/arc" << std::endl;
+  for (size_t transitions : {1000, 10000, 100000}) {
+    constexpr size_t arcs_per_transition = 8;
+    const size_t places = transitions;
+    std::uniform_int_distribution<size_t> place(0, places - 1);
+
+    // interleaving the row allocations with other allocations scatters them
+    // over the heap, as it happens when a net is built from a parsed file.
+    std::vector<SmallVectorInput> input_n;
+    std::vector<std::vector<char>> clutter;
+    for (size_t t = 0; t < transitions; t++) {
+      SmallVectorInput inputs;
+      for (size_t i = 0; i < arcs_per_transition; i++) {
+        inputs.push_back({place(rng), Success});
+      }
+      input_n.push_back(inputs);
+      clutter.emplace_back(64 + place(rng) % 256);
+    }
+    const auto arc_table = createArcTable(input_n);
+
+    std::vector<size_t> random_order(transitions);
+    std::iota(random_order.begin(), random_order.end(), 0);
+    std::shuffle(random_order.begin(), random_order.end(), rng);
+    std::vector<size_t> sequential_order(transitions);
+    std::iota(sequential_order.begin(), sequential_order.end(), 0);
+
+    const size_t arcs = transitions * arcs_per_transition;
+    for (const auto& [name, order] :
+         {std::make_pair("random", &random_order),
+          std::make_pair("in order", &sequential_order)}) {
+      const auto vector_result = measure(arcs, [&, order = order] {
+        uint64_t sum = 0;
+        for (const auto t : *order) {
+          for (const auto& [p, c] : input_n[t]) {
+            sum += p + c.toIndex();
+          }
+        }
+        return sum;
+      });
+      const auto csr_result = measure(arcs, [&, order = order] {
+        uint64_t sum = 0;
+        for (const auto t : *order) {
+          for (const auto& [p, c] : arc_table[t]) {
+            sum += p + c.toIndex();
+          }
+        }
+        return sum;
+      });
+      print(arcs, "vector", name, vector_result);
+      print(arcs, "csr", name, csr_result);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,57 @@
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+
+#include "symmetri/symmetri.h"
+
+// Measures how many asynchronous completions per second the event loop of a
+// PetriNet processes. The net has a single transition t that moves a token
+// from Pa back to Pa; `in_flight` tokens keep that many Callbacks running on
+// the threadpool at the same time. The Callback does no work, so the loop and
+// the queue between the threadpool and the loop are the bottleneck. After
+// `completions` firings the Callback returns Failed, which disables t, so the
+// net deadlocks once all tokens are spent. Every configuration also runs with a
+// few maximum batch sizes, and reports the sizes of the batches the loop
+// applied.
+using namespace symmetri;
+
+int main() {
+  constexpr size_t completions = 200000;
+  std::cout << std::setw(10) << "threads" << std::setw(12) << "in flight"
+            << std::setw(12) << "max batch" << std::setw(20)
+            << "[completions/s]" << std::setw(14) << "mean batch"
+            << std::setw(16) << "largest batch" << std::endl;
+  for (size_t threads : {1, 4}) {
+    for (size_t in_flight : {1, 16, 64}) {
+      for (size_t max_batch_size : {1, 16, 1024}) {
+        auto pool = std::make_shared<TaskSystem>(threads);
+        const Net net = {{"t", {{{"Pa", Success}}, {{"Pa", Success}}}}};
+        const Marking m0(in_flight, {"Pa", Success});
+        PetriNet petri(net, "completions", pool, m0);
+        petri.setMaxBatchSize(max_batch_size);
+        std::atomic<size_t> fired = 0;
+        petri.registerCallback("t", [&fired]() -> Token {
+          if (fired.fetch_add(1, std::memory_order_relaxed) < completions) {
+            return Success;
+          }
+          return Failed;
+        });
+
+        const auto begin = Clock::now();
+        fire(petri);
+        const auto end = Clock::now();
+        const auto s = std::chrono::duration<double>(end - begin).count();
+        const auto statistics = petri.getBatchStatistics();
+        std::cout << std::setw(10) << threads << std::setw(12) << in_flight
+                  << std::setw(12) << max_batch_size << std::setw(20)
+                  << static_cast<size_t>(fired.load() / s) << std::setw(14)
+                  << static_cast<double>(statistics.events) /
+                         statistics.batches
+                  << std::setw(16) << statistics.largest << std::endl;
+      }
+    }
+  }
+  return 0;
+}
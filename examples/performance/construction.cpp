@@ -0,0 +1,55 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "petri.h"
+
+// Measures how long it takes to construct a Petri from a Net. The net is a
+// ring of n transitions; t_i moves a token from p_i to p_i+1 and borrows one of
+// 64 shared resource places. Every transition has a priority and every 8th ring
+// place holds a token, so all construction steps (interning the names, the arc
+// tables, the reverse lookup, the priorities and the initial marking) scale
+// with the size of the net.
+using namespace symmetri;
+
+int main() {
+  auto pool = std::make_shared<TaskSystem>(1);
+  std::cout << std::setw(10) << "n" << std::setw(14) << "arcs"
+            << std::setw(16) << "total [ms]" << std::setw(20)
+            << "per transition [ns]" << std::endl;
+  for (size_t n : {1000, 10000, 100000, 1000000}) {
+    Net net;
+    Marking m0;
+    PriorityTable priorities;
+    net.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+      const auto t = "t" + std::to_string(i);
+      const auto p = "p" + std::to_string(i);
+      const auto r = "r" + std::to_string(i % 64);
+      net[t] = {{{p, Success}, {r, Success}},
+                {{"p" + std::to_string((i + 1) % n), Success}, {r, Success}}};
+      priorities.push_back({t, static_cast<int8_t>(i % 3)});
+      if (i % 8 == 0) {
+        m0.push_back({p, Success});
+      }
+    }
+    for (size_t i = 0; i < 64; i++) {
+      m0.push_back({"r" + std::to_string(i), Success});
+    }
+
+    const auto begin = Clock::now();
+    Petri m(net, priorities, m0, {{"p0", Success}}, "bench", pool);
+    const auto end = Clock::now();
+
+    const auto ms = std::chrono::duration<double, std::milli>(end - begin);
+    std::cout << std::setw(10) << n << std::setw(14) << 4 * n << std::setw(16)
+              << ms.count() << std::setw(20) << ms.count() * 1e6 / n
+              << std::endl;
+    if (m.net.transition.size() != n || m.net.place.size() != n + 64) {
+      std::cerr << "unexpected net size" << std::endl;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,89 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "petri.h"
+
+// Compares the generic enabling check with the bit-parallel engine on a 1-safe
+// net. The net is a ring of n transitions, t_i moves the token from p_i to
+// p_i+1 and also needs one of 16 shared resource places. A quarter of the ring
+// places hold a token.
+using namespace symmetri;
+
+template <typename F>
+double nsPerTransition(size_t transitions, F&& f) {
+  const size_t repetitions = std::max<size_t>(10, 10000000 / transitions);
+  size_t enabled = 0;
+  const auto begin = Clock::now();
+  for (size_t i = 0; i < repetitions; i++) {
+    enabled += f();
+  }
+  const auto end = Clock::now();
+  if (enabled != repetitions * transitions / 4) {
+    std::cerr << "unexpected amount of enabled transitions" << std::endl;
+  }
+  return std::chrono::duration<double, std::nano>(end - begin).count() /
+         (repetitions * transitions);
+}
+
+int main() {
+  auto pool = std::make_shared<TaskSystem>(1);
+  std::cout << std::setw(8) << "n" << std::setw(16) << "generic [ns]"
+            << std::setw(16) << "bitset [ns]" << std::setw(16) << "bulk [ns]"
+            << std::endl;
+  for (size_t n : {16, 64, 512, 4096, 32768, 262144}) {
+    Net net;
+    Marking m0;
+    for (size_t i = 0; i < n; i++) {
+      const auto p = "p" + std::to_string(i);
+      const auto r = "r" + std::to_string(i % 16);
+      net["t" + std::to_string(i)] = {
+          {{p, Success}, {r, Success}},
+          {{"p" + std::to_string((i + 1) % n), Success}, {r, Success}}};
+      if (i % 4 == 0) {
+        m0.push_back({p, Success});
+      }
+    }
+    for (size_t i = 0; i < 16; i++) {
+      m0.push_back({"r" + std::to_string(i), Success});
+    }
+    Petri m(net, {}, m0, {}, "bench", pool);
+
+    const auto generic_ns = nsPerTransition(n, [&] {
+      size_t enabled = 0;
+      for (size_t t = 0; t < n; t++) {
+        enabled += m.tokens.canFire(m.net.input_n[t]);
+      }
+      return enabled;
+    });
+
+    const auto bitset_ns = nsPerTransition(n, [&] {
+      size_t enabled = 0;
+      for (size_t t = 0; t < n; t++) {
+        enabled += m.enabling.canFire(t, m.net.input_n[t], m.tokens);
+      }
+      return enabled;
+    });
+
+    std::cout << std::setw(8) << n << std::setw(16) << generic_ns
+              << std::setw(16) << bitset_ns;
+    if (m.enabling.hasBulk()) {
+      std::vector<uint64_t> enabled;
+      const auto bulk_ns = nsPerTransition(n, [&] {
+        m.enabling.enabledTransitions(m.tokens, enabled);
+        size_t count = 0;
+        for (const auto word : enabled) {
+          count += static_cast<size_t>(__builtin_popcountll(word));
+        }
+        return count;
+      });
+      std::cout << std::setw(16) << bulk_ns;
+    } else {
+      std::cout << std::setw(16) << "n/a";
+    }
+    std::cout << std::endl;
+  }
+  return 0;
+}
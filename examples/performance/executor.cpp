@@ -0,0 +1,79 @@
+#include <chrono>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "symmetri/executor.h"
+#include "symmetri/symmetri.h"
+
+// Measures the throughput of an Executor against the amount of nets that run
+// concurrently. Every net is a chain of `length` transitions with Callbacks
+// that return right away, so the run time is dominated by the event loops and
+// the hand-overs between them and the TaskSystem. With fire, every concurrent
+// net would need a thread of its own; the Executor drives all of them from
+// `loops` threads. It reports the finished runs and transitions per second.
+using namespace symmetri;
+
+namespace {
+
+NetTemplate chain(size_t length) {
+  Net net;
+  for (size_t i = 0; i < length; i++) {
+    net.insert({"t" + std::to_string(i),
+                {{{"P" + std::to_string(i), Success}},
+                 {{"P" + std::to_string(i + 1), Success}}}});
+  }
+  return NetTemplate(net, {{"P0", Success}});
+}
+
+double runsPerSecond(size_t loops, size_t concurrent, size_t length) {
+  auto pool = std::make_shared<TaskSystem>(std::thread::hardware_concurrency());
+  const auto net = chain(length);
+  const Marking goal = {{"P" + std::to_string(length), Success}};
+  std::vector<std::unique_ptr<PetriNet>> nets;
+  for (size_t i = 0; i < concurrent; i++) {
+    nets.push_back(std::make_unique<PetriNet>(net, "case" + std::to_string(i),
+                                              pool, goal));
+    for (size_t t = 0; t < length; t++) {
+      nets.back()->registerCallback("t" + std::to_string(t),
+                                    [] { return Success; });
+    }
+  }
+
+  Executor executor(loops);
+  std::vector<std::future<Token>> results;
+  results.reserve(concurrent);
+  const auto begin = Clock::now();
+  for (const auto& net : nets) {
+    results.push_back(executor.submit(*net));
+  }
+  for (auto& result : results) {
+    if (!(result.get() == Success)) {
+      std::cerr << "a run failed" << std::endl;
+    }
+  }
+  const auto end = Clock::now();
+  return concurrent / std::chrono::duration<double>(end - begin).count();
+}
+
+}  // namespace
+
+int main() {
+  constexpr size_t length = 16;
+  std::cout << std::setw(8) << "loops" << std::setw(12) << "concurrent"
+            << std::setw(16) << "runs/s" << std::setw(20) << "transitions/s"
+            << std::endl;
+  for (size_t loops : {1, 2, 4}) {
+    for (size_t concurrent : {1, 10, 100, 1000, 10000}) {
+      const auto runs = runsPerSecond(loops, concurrent, length);
+      std::cout << std::setw(8) << loops << std::setw(12) << concurrent
+                << std::setw(16) << static_cast<size_t>(runs) << std::setw(20)
+                << static_cast<size_t>(runs * length) << std::endl;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,104 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "symmetri/symmetri.h"
+
+#if defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define SYMMETRI_HAS_MALLINFO2
+#endif
+
+// Compares creating PetriNet instances from a Net, which compiles the net for
+// every instance, with creating them from a NetTemplate, which compiles it
+// once and shares it. The nets are rings of n transitions; t_i moves a token
+// from p_i to p_i+1. Per instance the time to create it and the heap memory it
+// keeps are reported. Memory is measured as the growth of the allocated heap
+// while all instances are alive, if the C library can report it. The last row
+// per size runs every template instance once, with asynchronous Callbacks, up
+// to p_n-1, so it includes what a run leaves behind: the event log and the
+// latency histograms of the transitions that fired.
+using namespace symmetri;
+
+size_t heapInUse() {
+#if defined(SYMMETRI_HAS_MALLINFO2)
+  return mallinfo2().uordblks;
+#else
+  return 0;
+#endif
+}
+
+struct Result {
+  double us_per_instance;
+  double bytes_per_instance;
+};
+
+template <typename F>
+Result measure(size_t instances, F&& create) {
+  std::vector<PetriNet> nets;
+  nets.reserve(instances);
+  const auto heap_before = heapInUse();
+  const auto begin = Clock::now();
+  for (size_t i = 0; i < instances; i++) {
+    nets.push_back(create("case_" + std::to_string(i)));
+  }
+  const auto end = Clock::now();
+  const auto heap_after = heapInUse();
+  const auto us = std::chrono::duration<double, std::micro>(end - begin);
+  return {us.count() / instances,
+          (static_cast<double>(heap_after) - heap_before) / instances};
+}
+
+void print(size_t n, const char* source, const Result& r) {
+  std::cout << std::setw(8) << n << std::setw(10) << source << std::setw(18)
+            << r.us_per_instance;
+  if (heapInUse() == 0) {
+    std::cout << std::setw(20) << "n/a";
+  } else {
+    std::cout << std::setw(20) << r.bytes_per_instance;
+  }
+  std::cout << std::endl;
+}
+
+int main() {
+  auto pool = std::make_shared<TaskSystem>(1);
+  std::cout << std::setw(8) << "n" << std::setw(10) << "source"
+            << std::setw(18) << "[us/instance]" << std::setw(20)
+            << "[bytes/instance]" << std::endl;
+  for (size_t n : {10, 100, 1000}) {
+    Net net;
+    for (size_t i = 0; i < n; i++) {
+      net["t" + std::to_string(i)] = {
+          {{"p" + std::to_string(i), Success}},
+          {{"p" + std::to_string((i + 1) % n), Success}}};
+    }
+    const Marking m0 = {{"p0", Success}};
+    const size_t instances = 100000 / n;
+
+    const auto from_net = measure(instances, [&](const std::string& case_id) {
+      return PetriNet(net, case_id, pool, m0);
+    });
+    const NetTemplate compiled_net(net, m0);
+    const auto from_template =
+        measure(instances, [&](const std::string& case_id) {
+          return PetriNet(compiled_net, case_id, pool);
+        });
+    const Marking goal = {{"p" + std::to_string(n - 1), Success}};
+    const auto fired = measure(instances, [&](const std::string& case_id) {
+      PetriNet app(compiled_net, case_id, pool, goal);
+      for (size_t i = 0; i < n; i++) {
+        app.registerCallback("t" + std::to_string(i), [] {});
+      }
+      fire(app);
+      return app;
+    });
+    print(n, "net", from_net);
+    print(n, "template", from_template);
+    print(n, "fired", fired);
+  }
+  return 0;
+}
@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "symmetri/symmetri.h"
+
+// Measures the latency from the completion of a Callback to the start of the
+// next one. The net is a single transition t that moves one token from Pa back
+// to Pa, so every completion enables exactly one new dispatch: the completion
+// travels to the event loop, the loop fires t and the task travels back to a
+// worker. The Callback stores when it starts and when it ends; the latency is
+// the time between the end of one firing and the start of the next. Both the
+// event loop and the TaskSystem wait with the same WaitPolicy. Spinning only
+// pays off if the loop and the worker have a core each; on fewer cores the
+// spinning thread takes the time slice of the thread it is waiting for.
+using namespace symmetri;
+
+int main() {
+  constexpr size_t samples = 20000;
+  const std::vector<std::pair<const char*, WaitPolicy>> modes = {
+      {"park", {}}, {"yield", {0, 100000}}, {"spin", {1000000, 0}}};
+
+  std::cout << std::setw(8) << "mode" << std::setw(14) << "p50 [us]"
+            << std::setw(14) << "p99 [us]" << std::setw(14) << "p999 [us]"
+            << std::setw(14) << "max [us]" << std::endl;
+  for (const auto& [name, policy] : modes) {
+    auto pool = std::make_shared<TaskSystem>(1, policy);
+    const Net net = {{"t", {{{"Pa", Success}}, {{"Pa", Success}}}}};
+    PetriNet petri(net, "latency", pool, {{"Pa", Success}});
+    petri.setWaitPolicy(policy);
+
+    std::vector<Clock::time_point> starts, ends;
+    starts.reserve(samples + 1);
+    ends.reserve(samples + 1);
+    petri.registerCallback("t", [&]() -> Token {
+      starts.push_back(Clock::now());
+      const bool is_done = starts.size() > samples;
+      ends.push_back(Clock::now());
+      if (is_done) {
+        return Failed;
+      }
+      return Success;
+    });
+    fire(petri);
+
+    std::vector<double> latencies;
+    latencies.reserve(samples);
+    for (size_t i = 1; i < starts.size(); i++) {
+      latencies.push_back(
+          std::chrono::duration<double, std::micro>(starts[i] - ends[i - 1])
+              .count());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&latencies](double p) {
+      return latencies[std::min(latencies.size() - 1,
+                                static_cast<size_t>(p * latencies.size()))];
+    };
+    std::cout << std::setw(8) << name << std::setw(14) << percentile(0.5)
+              << std::setw(14) << percentile(0.99) << std::setw(14)
+              << percentile(0.999) << std::setw(14) << latencies.back()
+              << std::endl;
+  }
+  return 0;
+}
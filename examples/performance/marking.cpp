@@ -0,0 +1,60 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "petri.h"
+
+// Compares the enabling check and deduction of the token-vector marking with
+// the DenseMarking. The net has a buffer place (0) that holds `n` tokens and a
+// control place (1) with one token. The transition consumes one token from
+// both and immediately puts them back, so the marking size stays constant.
+using namespace symmetri;
+
+template <typename F>
+double nsPerIteration(size_t iterations, F&& f) {
+  const auto begin = Clock::now();
+  for (size_t i = 0; i < iterations; i++) {
+    f();
+  }
+  const auto end = Clock::now();
+  return std::chrono::duration<double, std::nano>(end - begin).count() /
+         iterations;
+}
+
+int main() {
+  const SmallVectorInput pre = {{0, Success}, {1, Success}};
+  const std::vector<Arc> arcs = {{0, Success}, {1, Success}};
+  std::cout << std::setw(10) << "tokens" << std::setw(16) << "vector [ns]"
+            << std::setw(16) << "dense [ns]" << std::setw(12) << "speedup"
+            << std::endl;
+  for (size_t n : {10, 100, 1000, 10000, 100000}) {
+    std::vector<AugmentedToken> m0(n, {0, Success});
+    m0.push_back({1, Success});
+    const size_t iterations = std::max<size_t>(1000, 10000000 / n);
+
+    auto vector_marking = m0;
+    const auto vector_ns = nsPerIteration(iterations, [&] {
+      if (canFire(pre, vector_marking)) {
+        deductMarking(vector_marking, pre);
+        vector_marking.insert(vector_marking.end(), pre.begin(), pre.end());
+      }
+    });
+
+    DenseMarking dense_marking(2);
+    dense_marking.reset(m0);
+    const auto dense_ns = nsPerIteration(iterations, [&] {
+      if (dense_marking.canFire(arcs)) {
+        dense_marking.deduct(arcs);
+        for (const auto& [p, c] : arcs) {
+          dense_marking.add(p, c);
+        }
+      }
+    });
+
+    std::cout << std::setw(10) << n << std::setw(16) << vector_ns
+              << std::setw(16) << dense_ns << std::setw(12)
+              << vector_ns / dense_ns << std::endl;
+  }
+  return 0;
+}
@@ -11,7 +11,7 @@ symmetri::Token fire(const Simple &) {
 }
 
 void printLog(const symmetri::Eventlog &eventlog) {
-  for (const auto &[caseid, t, s, c] : eventlog) {
+  for (const auto &[caseid, t, s, c, instance] : eventlog) {
     std::cout << "Eventlog: " << caseid << ", " << t << ", " << s.toString()
               << ", " << c.time_since_epoch().count() << std::endl;
   }
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "symmetri/symmetri.h"
+
+// Measures how long a high-priority transition waits for a worker while the
+// TaskSystem is overloaded with low-priority work. Transition `low` moves a
+// token from Pl back to Pl and keeps `backlog` Callbacks of about 20us each
+// queued. Transition `high` moves a single token from Ph back to Ph and has a
+// higher priority. The delay is the time from the end of one firing of `high`
+// to the start of the next, so it includes the trip through the event loop.
+// With a shared FIFO queue `high` waits behind the whole backlog; with
+// priority scheduling it only waits for the Callbacks that are already
+// running.
+using namespace symmetri;
+
+namespace {
+
+void work(std::chrono::microseconds duration) {
+  const auto until = Clock::now() + duration;
+  while (Clock::now() < until) {
+  }
+}
+
+}  // namespace
+
+int main() {
+  constexpr size_t samples = 500;
+  constexpr size_t threads = 2;
+  const std::pair<const char*, Scheduling> schedulers[] = {
+      {"shared", Scheduling::SharedQueue}, {"priority", Scheduling::Priority}};
+
+  std::cout << std::setw(10) << "scheduler" << std::setw(10) << "backlog"
+            << std::setw(14) << "p50 [us]" << std::setw(14) << "p99 [us]"
+            << std::setw(14) << "max [us]" << std::endl;
+  for (const auto& [name, scheduling] : schedulers) {
+    for (size_t backlog : {16, 256}) {
+      TaskSystemConfig config;
+      config.thread_count = threads;
+      config.scheduling = scheduling;
+      auto pool = std::make_shared<TaskSystem>(config);
+      const Net net = {{"low", {{{"Pl", Success}}, {{"Pl", Success}}}},
+                       {"high", {{{"Ph", Success}}, {{"Ph", Success}}}}};
+      Marking m0(backlog, {"Pl", Success});
+      m0.push_back({"Ph", Success});
+      PetriNet petri(net, "priority_dispatch", pool, m0, {},
+                     {{"low", 0}, {"high", 1}});
+
+      std::atomic<bool> is_done = false;
+      std::vector<Clock::time_point> starts, ends;
+      starts.reserve(samples + 1);
+      ends.reserve(samples + 1);
+      petri.registerCallback("low", [&is_done]() -> Token {
+        work(std::chrono::microseconds(20));
+        if (is_done.load()) {
+          return Failed;
+        }
+        return Success;
+      });
+      petri.registerCallback("high", [&]() -> Token {
+        starts.push_back(Clock::now());
+        if (starts.size() > samples) {
+          is_done.store(true);
+          ends.push_back(Clock::now());
+          return Failed;
+        }
+        ends.push_back(Clock::now());
+        return Success;
+      });
+      fire(petri);
+
+      std::vector<double> delays;
+      for (size_t i = 1; i < starts.size(); i++) {
+        delays.push_back(
+            std::chrono::duration<double, std::micro>(starts[i] - ends[i - 1])
+                .count());
+      }
+      std::sort(delays.begin(), delays.end());
+      const auto percentile = [&delays](double p) {
+        return delays[std::min(delays.size() - 1,
+                               static_cast<size_t>(p * delays.size()))];
+      };
+      std::cout << std::setw(10) << name << std::setw(10) << backlog
+                << std::setw(14) << percentile(0.5) << std::setw(14)
+                << percentile(0.99) << std::setw(14) << delays.back()
+                << std::endl;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,82 @@
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include "symmetri/symmetri.h"
+
+// Compares the schedulers of the TaskSystem with fine-grained tasks. In the
+// flat workload the main thread pushes `tasks` tiny tasks, so every task goes
+// through the queue that is shared by all threads. In the nested workload a
+// task forks two child tasks until it reaches the depth of the tree, so almost
+// all tasks are pushed by the workers themselves, like the Callbacks of nested
+// nets do. Both report how many tasks per second the pool ran. Work-stealing
+// only pays off if the workers have a core each; with more threads than cores
+// both schedulers mostly measure the operating system.
+using namespace symmetri;
+
+namespace {
+
+void waitFor(std::atomic<size_t>& counter, size_t target) {
+  while (counter.load(std::memory_order_acquire) < target) {
+    std::this_thread::yield();
+  }
+}
+
+double flat(Scheduling scheduling, size_t threads, size_t tasks) {
+  TaskSystem pool(threads, {}, scheduling);
+  std::atomic<size_t> done = 0;
+  const auto begin = Clock::now();
+  for (size_t i = 0; i < tasks; i++) {
+    pool.push([&done] { done.fetch_add(1, std::memory_order_release); });
+  }
+  waitFor(done, tasks);
+  const auto end = Clock::now();
+  return tasks / std::chrono::duration<double>(end - begin).count();
+}
+
+void forkTree(const TaskSystem& pool, std::atomic<size_t>& done, size_t depth) {
+  if (depth > 0) {
+    pool.push([&pool, &done, depth] { forkTree(pool, done, depth - 1); });
+    pool.push([&pool, &done, depth] { forkTree(pool, done, depth - 1); });
+  }
+  done.fetch_add(1, std::memory_order_release);
+}
+
+double nested(Scheduling scheduling, size_t threads, size_t depth) {
+  TaskSystem pool(threads, {}, scheduling);
+  std::atomic<size_t> done = 0;
+  const size_t tasks = (size_t(1) << (depth + 1)) - 1;
+  const auto begin = Clock::now();
+  pool.push([&pool, &done, depth] { forkTree(pool, done, depth); });
+  waitFor(done, tasks);
+  const auto end = Clock::now();
+  return tasks / std::chrono::duration<double>(end - begin).count();
+}
+
+}  // namespace
+
+int main() {
+  constexpr size_t tasks = 1 << 18;
+  constexpr size_t depth = 17;
+  const std::pair<const char*, Scheduling> schedulers[] = {
+      {"shared", Scheduling::SharedQueue},
+      {"stealing", Scheduling::WorkStealing}};
+
+  std::cout << std::setw(10) << "threads" << std::setw(12) << "scheduler"
+            << std::setw(20) << "flat [tasks/s]" << std::setw(20)
+            << "nested [tasks/s]" << std::endl;
+  for (size_t threads : {1, 2, 4, 8, 16, 32, 64}) {
+    for (const auto& [name, scheduling] : schedulers) {
+      std::cout << std::setw(10) << threads << std::setw(12) << name
+                << std::setw(20)
+                << static_cast<size_t>(flat(scheduling, threads, tasks))
+                << std::setw(20)
+                << static_cast<size_t>(nested(scheduling, threads, depth))
+                << std::endl;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "symmetri/symmetri.h"
+
+// Measures the expiry jitter of delayed tasks while 100k of them are pending
+// at once, and the run time of a net that delays 100k tokens in one
+// transition. Pending delays wait in the timer wheel of the TaskSystem, so
+// they occupy no thread; a delay that sleeps in its Callback would need a
+// thread for every pending delay. The jitter is the time between the end of a
+// delay and the moment its task runs on a worker.
+using namespace symmetri;
+
+namespace {
+
+constexpr size_t timer_count = 100000;
+
+void jitter(std::chrono::steady_clock::duration resolution) {
+  TaskSystemConfig config;
+  config.thread_count = 1;
+  config.timer_resolution = resolution;
+  auto pool = std::make_shared<TaskSystem>(config);
+
+  std::mt19937 random(42);
+  // the first delay expires after all timers are added, so all are pending.
+  std::uniform_int_distribution<int> delay_us(100000, 1000000);
+  std::vector<std::chrono::steady_clock::duration> lateness(timer_count);
+  std::atomic<size_t> remaining(timer_count);
+  std::promise<void> done;
+  for (size_t i = 0; i < timer_count; i++) {
+    const auto delay = std::chrono::microseconds(delay_us(random));
+    const auto deadline = std::chrono::steady_clock::now() + delay;
+    pool->pushAfter(delay, [&, i, deadline] {
+      lateness[i] = std::chrono::steady_clock::now() - deadline;
+      if (--remaining == 0) {
+        done.set_value();
+      }
+    });
+  }
+  done.get_future().wait();
+
+  std::sort(lateness.begin(), lateness.end());
+  const auto us = [](std::chrono::steady_clock::duration d) {
+    return std::chrono::duration<double, std::micro>(d).count();
+  };
+  std::cout << std::setw(14) << us(resolution) << std::setw(12)
+            << us(lateness[timer_count / 2]) << std::setw(12)
+            << us(lateness[timer_count * 99 / 100]) << std::setw(12)
+            << us(lateness.back()) << std::endl;
+}
+
+void delayedNet(std::chrono::milliseconds delay) {
+  Marking initial_marking, goal_marking;
+  for (size_t i = 0; i < timer_count; i++) {
+    initial_marking.push_back({"Pa", Success});
+    goal_marking.push_back({"Pb", Success});
+  }
+  auto pool = std::make_shared<TaskSystem>(1);
+  PetriNet net({{"t", {{{"Pa", Success}}, {{"Pb", Success}}}}}, "delays", pool,
+               initial_marking, goal_marking);
+  net.registerCallback("t", [] { return Success; });
+  net.setDelay("t", delay);
+  const auto begin = Clock::now();
+  const auto result = fire(net);
+  const auto end = Clock::now();
+  std::cout << timer_count << " tokens delayed by " << delay.count()
+            << " ms on 1 thread: " << result.toString() << " after "
+            << std::chrono::duration<double, std::milli>(end - begin).count()
+            << " ms" << std::endl;
+}
+
+}  // namespace
+
+int main() {
+  std::cout << timer_count << " pending timers, delays of 100 ms to 1 s"
+            << std::endl;
+  std::cout << std::setw(14) << "resolution us" << std::setw(12) << "p50 us"
+            << std::setw(12) << "p99 us" << std::setw(12) << "max us"
+            << std::endl;
+  for (auto resolution : {std::chrono::microseconds(1000),
+                          std::chrono::microseconds(100),
+                          std::chrono::microseconds(10)}) {
+    jitter(resolution);
+  }
+  delayedNet(std::chrono::milliseconds(100));
+  return 0;
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+/** @file active_set.h */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <limits>
+#include <vector>
+
+#include "symmetri/tasks.h"
+#include "symmetri/types.h"
+
+namespace symmetri {
+
+/**
+ * @brief ActiveSet holds the active instances of transitions. Every firing of
+ * an asynchronous transition is an instance with its own id, until it ends, so
+ * concurrent firings of one transition keep their own bookkeeping. It is a slot
+ * map: an id points to a slot, which points to the instance in a dense array.
+ * Inserting, finding and removing an instance are therefore O(1), and
+ * iterating only visits active instances. A slot that is reused gets a new
+ * generation, so ids are not reused. Id 0 is never used.
+ *
+ */
+class ActiveSet {
+ public:
+  using Id = uint64_t;  ///< Identifies an instance: generation and slot
+
+  /**
+   * @brief Instance is one firing of a transition that has not ended yet.
+   *
+   */
+  struct Instance {
+    Id id;                           ///< The id of this instance
+    size_t transition;               ///< The transition as index
+    Clock::time_point scheduled;     ///< When the transition fired
+    bool is_delayed;                 ///< Set while it waits for its delay
+    TaskSystem::TimerId delay_timer;  ///< The timer of the delay, if delayed
+  };
+
+  /**
+   * @brief Adds an instance of a transition.
+   *
+   * @param transition
+   * @param scheduled when the transition fired
+   * @return Id the id of the new instance
+   */
+  Id insert(size_t transition, Clock::time_point scheduled) {
+    uint32_t slot;
+    if (free_.empty()) {
+      slot = static_cast<uint32_t>(slots_.size());
+      slots_.push_back({1, nil});
+    } else {
+      slot = free_.back();
+      free_.pop_back();
+    }
+    slots_[slot].dense = static_cast<uint32_t>(dense_.size());
+    const auto id = (Id(slots_[slot].generation) << 32) | slot;
+    dense_.push_back({id, transition, scheduled, false, 0});
+    return id;
+  }
+
+  /**
+   * @brief Finds an active instance.
+   *
+   * @param id
+   * @return Instance* the instance, or nullptr if it is not active
+   */
+  Instance* find(Id id) noexcept {
+    const auto slot = static_cast<uint32_t>(id);
+    if (slot >= slots_.size() ||
+        slots_[slot].generation != static_cast<uint32_t>(id >> 32) ||
+        slots_[slot].dense == nil) {
+      return nullptr;
+    }
+    return &dense_[slots_[slot].dense];
+  }
+
+  /**
+   * @brief Removes an instance. The last instance takes its place in the dense
+   * array, so pointers to instances are invalidated.
+   *
+   * @param id
+   * @return true if the instance was active
+   * @return false otherwise
+   */
+  bool erase(Id id) noexcept {
+    const auto instance = find(id);
+    if (instance == nullptr) {
+      return false;
+    }
+    const auto slot = static_cast<uint32_t>(id);
+    const auto dense = slots_[slot].dense;
+    *instance = dense_.back();
+    slots_[static_cast<uint32_t>(instance->id)].dense = dense;
+    dense_.pop_back();
+    release(slot);
+    return true;
+  }
+
+  /**
+   * @brief Removes all instances.
+   *
+   */
+  void clear() noexcept {
+    for (const auto& instance : dense_) {
+      release(static_cast<uint32_t>(instance.id));
+    }
+    dense_.clear();
+  }
+
+  bool empty() const noexcept { return dense_.empty(); }
+  size_t size() const noexcept { return dense_.size(); }
+  std::vector<Instance>::const_iterator begin() const noexcept {
+    return dense_.cbegin();
+  }
+  std::vector<Instance>::const_iterator end() const noexcept {
+    return dense_.cend();
+  }
+
+ private:
+  static constexpr uint32_t nil =
+      std::numeric_limits<uint32_t>::max();  ///< A slot without instance
+
+  struct Slot {
+    uint32_t generation;  ///< Tells ids of reused slots apart, starts at 1
+    uint32_t dense;       ///< The index of the instance, or nil
+  };
+
+  void release(uint32_t slot) noexcept {
+    slots_[slot].dense = nil;
+    // generation 0 is skipped, so that id 0 never occurs.
+    if (++slots_[slot].generation == 0) {
+      slots_[slot].generation = 1;
+    }
+    free_.push_back(slot);
+  }
+
+  std::vector<Slot> slots_;       ///< The slots, indexed by the low half of ids
+  std::vector<Instance> dense_;   ///< The active instances
+  std::vector<uint32_t> free_;    ///< The unused slots
+};
+
+}  // namespace symmetri
@@ -0,0 +1,139 @@
+#include "affinity.h"
+
+#include <fstream>
+#include <string>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace symmetri {
+
+namespace {
+
+std::vector<size_t> readCpuList(const std::string& path) {
+  std::ifstream file(path);
+  std::string list;
+  if (!std::getline(file, list)) {
+    return {};
+  }
+  return parseCpuList(list);
+}
+
+size_t parseNumber(std::string_view text, bool& ok) {
+  size_t value = 0;
+  ok = !text.empty();
+  for (const char c : text) {
+    if (c < '0' || c > '9') {
+      ok = false;
+      return 0;
+    }
+    value = value * 10 + static_cast<size_t>(c - '0');
+  }
+  return value;
+}
+
+#if defined(__linux__)
+std::vector<size_t> currentAffinity() {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+    return {};
+  }
+  std::vector<size_t> cpus;
+  for (size_t cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (CPU_ISSET(cpu, &set)) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+#endif
+
+}  // namespace
+
+std::vector<size_t> parseCpuList(std::string_view list) {
+  std::vector<size_t> cpus;
+  while (!list.empty()) {
+    const auto comma = list.find(',');
+    auto range = list.substr(0, comma);
+    list = comma == std::string_view::npos ? std::string_view()
+                                           : list.substr(comma + 1);
+    while (!range.empty() && (range.back() == '\n' || range.back() == ' ')) {
+      range.remove_suffix(1);
+    }
+    const auto dash = range.find('-');
+    bool first_ok = false;
+    bool last_ok = false;
+    const auto first = parseNumber(range.substr(0, dash), first_ok);
+    const auto last =
+        dash == std::string_view::npos
+            ? parseNumber(range, last_ok)
+            : parseNumber(range.substr(dash + 1), last_ok);
+    if (!first_ok || !last_ok || last < first) {
+      continue;
+    }
+    for (auto cpu = first; cpu <= last; cpu++) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+std::vector<size_t> onlineCpus() {
+  return readCpuList("/sys/devices/system/cpu/online");
+}
+
+std::vector<size_t> numaNodeCpus(size_t node) {
+  return readCpuList("/sys/devices/system/node/node" + std::to_string(node) +
+                     "/cpulist");
+}
+
+bool setCurrentThreadAffinity(const std::vector<size_t>& cpus) {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  bool any = false;
+  for (const auto cpu : cpus) {
+    if (cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &set);
+      any = true;
+    }
+  }
+  return any &&
+         pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  (void)cpus;
+  return false;
+#endif
+}
+
+void setCurrentThreadName(const std::string& name) {
+#if defined(__linux__)
+  pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+#else
+  (void)name;
+#endif
+}
+
+ScopedAffinity::ScopedAffinity(const std::vector<size_t>& cpus) {
+#if defined(__linux__)
+  if (!cpus.empty()) {
+    auto previous = currentAffinity();
+    if (setCurrentThreadAffinity(cpus)) {
+      previous_ = std::move(previous);
+    }
+  }
+#else
+  (void)cpus;
+#endif
+}
+
+ScopedAffinity::~ScopedAffinity() noexcept {
+  if (!previous_.empty()) {
+    setCurrentThreadAffinity(previous_);
+  }
+}
+
+}  // namespace symmetri
@@ -0,0 +1,73 @@
+#pragma once
+
+/** @file affinity.h */
+
+#include <stddef.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace symmetri {
+
+/**
+ * @brief Parses a Linux CPU list, such as "0-3,8,10-11", as found in
+ * /sys/devices/system/cpu/online and /sys/devices/system/node/node<N>/cpulist.
+ *
+ * @param list
+ * @return std::vector<size_t> the CPUs in ascending order. Malformed entries
+ * are skipped.
+ */
+std::vector<size_t> parseCpuList(std::string_view list);
+
+/**
+ * @brief Gets the CPUs that are online.
+ *
+ * @return std::vector<size_t> empty if the topology can not be discovered.
+ */
+std::vector<size_t> onlineCpus();
+
+/**
+ * @brief Gets the CPUs that belong to a NUMA node.
+ *
+ * @param node
+ * @return std::vector<size_t> empty if the node does not exist, or if the
+ * topology can not be discovered.
+ */
+std::vector<size_t> numaNodeCpus(size_t node);
+
+/**
+ * @brief Restricts the calling thread to a set of CPUs.
+ *
+ * @param cpus
+ * @return true if the affinity was applied
+ * @return false if it is not supported, or if none of the CPUs is usable
+ */
+bool setCurrentThreadAffinity(const std::vector<size_t>& cpus);
+
+/**
+ * @brief Names the calling thread, so it shows up as such in top, perf and
+ * debuggers. Linux limits names to 15 characters; longer names are truncated.
+ *
+ * @param name
+ */
+void setCurrentThreadName(const std::string& name);
+
+/**
+ * @brief ScopedAffinity restricts the calling thread to a set of CPUs for its
+ * lifetime, and restores the previous affinity when it is destroyed. An empty
+ * set leaves the affinity untouched.
+ *
+ */
+class ScopedAffinity {
+ public:
+  explicit ScopedAffinity(const std::vector<size_t>& cpus);
+  ~ScopedAffinity() noexcept;
+  ScopedAffinity(const ScopedAffinity&) = delete;
+  ScopedAffinity& operator=(const ScopedAffinity&) = delete;
+
+ private:
+  std::vector<size_t> previous_;  ///< The affinity to restore, if any
+};
+
+}  // namespace symmetri
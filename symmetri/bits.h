@@ -0,0 +1,47 @@
+#pragma once
+
+/** @file bits.h */
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace symmetri {
+
+/**
+ * @brief Get the index of the lowest set bit. The word may not be zero.
+ *
+ * @param word
+ * @return size_t
+ */
+inline size_t lowestBit(uint64_t word) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<size_t>(__builtin_ctzll(word));
+#else
+  size_t i = 0;
+  while ((word & 1) == 0) {
+    word >>= 1;
+    i++;
+  }
+  return i;
+#endif
+}
+
+/**
+ * @brief Get the index of the highest set bit. The word may not be zero.
+ *
+ * @param word
+ * @return size_t
+ */
+inline size_t highestBit(uint64_t word) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  return 63 - static_cast<size_t>(__builtin_clzll(word));
+#else
+  size_t i = 0;
+  while (word >>= 1) {
+    i++;
+  }
+  return i;
+#endif
+}
+
+}  // namespace symmetri
@@ -0,0 +1,40 @@
+# symmetri_add_net(<target> <file> [<file>...])
+#
+# Compiles one or more PNML- or GRML-files into a header that defines a
+# constexpr symmetri::StaticNet, so the net can be constructed without parsing
+# XML at runtime. The header and the net are named after the first file; e.g.
+# nets/PT1.pnml becomes "nets/PT1.hpp", which defines symmetri::nets::PT1. The
+# header is regenerated whenever one of the files changes. The compiler leaves
+# an unchanged header alone, so a stamp file records that it ran; otherwise the
+# header would stay older than its files and be regenerated on every build.
+function(symmetri_add_net target file)
+  get_filename_component(stem ${file} NAME_WE)
+  string(MAKE_C_IDENTIFIER ${stem} name)
+  set(include_dir ${CMAKE_CURRENT_BINARY_DIR}/symmetri_nets)
+  set(header ${include_dir}/nets/${name}.hpp)
+  set(stamp ${include_dir}/nets/${name}.stamp)
+
+  set(files)
+  foreach(f ${file} ${ARGN})
+    get_filename_component(f ${f} ABSOLUTE)
+    list(APPEND files ${f})
+  endforeach()
+
+  if(TARGET symmetri_net_compiler)
+    set(compiler symmetri_net_compiler)
+  else()
+    set(compiler symmetri::symmetri_net_compiler)
+  endif()
+
+  add_custom_command(
+    OUTPUT ${stamp}
+    BYPRODUCTS ${header}
+    COMMAND ${compiler} ${header} ${name} ${files}
+    COMMAND ${CMAKE_COMMAND} -E touch ${stamp}
+    DEPENDS ${compiler} ${files}
+    COMMENT "Compiling net ${name}"
+    VERBATIM
+  )
+  target_sources(${target} PRIVATE ${stamp})
+  target_include_directories(${target} PRIVATE ${include_dir})
+endfunction()
@@ -0,0 +1,227 @@
+#pragma once
+
+/** @file completion_queue.h */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "symmetri/colors.hpp"
+#include "symmetri/types.h"
+
+namespace symmetri {
+
+/**
+ * @brief Completion is the result of an asynchronously fired transition, as
+ * it is sent from the TaskSystem back to the Petri event loop. It is a plain
+ * record, so it can be passed without allocation or type erasure.
+ *
+ */
+struct Completion {
+  uint32_t transition = 0;   ///< The transition as index
+  Token result = Scheduled;  ///< The token the Callback returned
+  Clock::time_point start;   ///< When the Callback started
+  Clock::time_point end;     ///< When the Callback finished
+  uint64_t instance = 0;     ///< The instance of the transition that fired
+  bool is_dispatched = false;  ///< True if the Callback was dispatched to the
+                               ///< TaskSystem, which gives it latencies
+  bool is_started = true;  ///< False if the Callback never started, as for a
+                           ///< delay that was cancelled
+};
+
+static_assert(std::is_trivially_copyable_v<Completion>,
+              "Completions are copied in and out of the ring.");
+
+/**
+ * @brief CompletionQueue is a bounded lock-free multi-producer single-consumer
+ * ring of Completions. Every cell has a sequence number that tells producers
+ * whether the cell is free and the consumer whether it is filled, so a
+ * producer only contends with other producers on the tail. Enqueueing fails if
+ * the ring is full; it never allocates.
+ *
+ * The ring does not block. A consumer that wants to block elsewhere announces
+ * it with prepareWait, and a producer that finds the announcement with
+ * takeWaiter after enqueueing has to wake it up with wake. Filling a cell,
+ * checking for emptiness and both sides of the announcement are sequentially
+ * consistent, so either the consumer sees the Completion or the producer sees
+ * the consumer. Events that are queued elsewhere, such as Reducers, take part
+ * in the same protocol by calling signal after they are queued.
+ *
+ */
+class CompletionQueue {
+ public:
+  /**
+   * @brief Construct a new CompletionQueue.
+   *
+   * @param capacity the amount of cells, rounded up to a power of two
+   */
+  explicit CompletionQueue(size_t capacity)
+      : head_(0), acknowledged_(0), tail_(0), signals_(0), is_waiting_(false) {
+    size_t size = 1;
+    while (size < capacity) {
+      size *= 2;
+    }
+    mask_ = size - 1;
+    cells_ = std::make_unique<Cell[]>(size);
+    for (size_t i = 0; i < size; i++) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Adds a Completion to the ring. It may be called from any thread.
+   *
+   * @param completion
+   * @return true if it was added
+   * @return false if the ring is full
+   */
+  bool tryEnqueue(const Completion& completion) noexcept {
+    auto position = tail_.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+      cell = &cells_[position & mask_];
+      const auto sequence = cell->sequence.load(std::memory_order_acquire);
+      const auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+      if (difference == 0) {
+        if (tail_.compare_exchange_weak(position, position + 1,
+                                        std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = tail_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->data = completion;
+    cell->sequence.store(position + 1, std::memory_order_seq_cst);
+    return true;
+  }
+
+  /**
+   * @brief Takes the oldest Completion from the ring. It may only be called
+   * from the consuming thread.
+   *
+   * @param completion is assigned the Completion, if there is one
+   * @return true if a Completion was taken
+   * @return false if the ring is empty
+   */
+  bool tryDequeue(Completion& completion) noexcept {
+    auto& cell = cells_[head_ & mask_];
+    if (cell.sequence.load(std::memory_order_acquire) != head_ + 1) {
+      return false;
+    }
+    completion = cell.data;
+    cell.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+    head_++;
+    return true;
+  }
+
+  /**
+   * @brief Checks if the ring is empty. It may only be called from the
+   * consuming thread.
+   *
+   * @return true
+   * @return false
+   */
+  bool empty() const noexcept {
+    return cells_[head_ & mask_].sequence.load(std::memory_order_seq_cst) !=
+           head_ + 1;
+  }
+
+  /**
+   * @brief Announces that the consumer is going to block, unless the ring is
+   * not empty or there are unacknowledged signals. It may only be called from
+   * the consuming thread. The announcement has to be withdrawn with finishWait
+   * after blocking, or taken back with takeWaiter if it is not going to block.
+   *
+   * @return true if the consumer may block
+   * @return false if there are events
+   */
+  bool prepareWait() noexcept {
+    // once the announcement is made, a producer may hand the consumer over to
+    // another thread, so the state of the consumer is read before.
+    const auto head = head_;
+    const auto acknowledged = acknowledged_;
+    is_waiting_.store(true);
+    return cells_[head & mask_].sequence.load(std::memory_order_seq_cst) !=
+               head + 1 &&
+           signals_.load() == acknowledged;
+  }
+
+  /**
+   * @brief Withdraws the announcement of prepareWait.
+   *
+   */
+  void finishWait() noexcept { is_waiting_.store(false); }
+
+  /**
+   * @brief Takes the announcement of a consumer that is going to block. It is
+   * called by producers after a successful tryEnqueue.
+   *
+   * @return true if the consumer has to be woken up
+   * @return false otherwise
+   */
+  bool takeWaiter() noexcept { return is_waiting_.exchange(false); }
+
+  /**
+   * @brief Announces an event that was queued elsewhere. It may be called from
+   * any thread, after the event is queued.
+   *
+   */
+  void signal() noexcept { signals_.fetch_add(1); }
+
+  /**
+   * @brief Gets the amount of signals so far. It is read by the consumer before
+   * it drains the events that were signalled.
+   *
+   * @return size_t
+   */
+  size_t signals() const noexcept { return signals_.load(); }
+
+  /**
+   * @brief Marks the signals up to a count that was read with signals as
+   * handled. It may only be called from the consuming thread, once all events
+   * queued before that count was read are drained.
+   *
+   * @param signals
+   */
+  void acknowledge(size_t signals) noexcept { acknowledged_ = signals; }
+
+  /**
+   * @brief Sets how a producer that took the announcement wakes up the
+   * consumer. It may only be called by the consumer while it is not waiting.
+   *
+   * @param wake
+   */
+  void setWake(std::function<void()> wake) { wake_ = std::move(wake); }
+
+  /**
+   * @brief Wakes up the consumer. It is called by the producer that took the
+   * announcement with takeWaiter.
+   *
+   */
+  void wake() const { wake_(); }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;  ///< Tells whether the cell is filled
+    Completion data;               ///< The Completion, if filled
+  };
+
+  std::unique_ptr<Cell[]> cells_;  ///< The ring
+  size_t mask_;                    ///< The amount of cells minus one
+  size_t head_;                    ///< The next cell to consume
+  size_t acknowledged_;            ///< The signals the consumer handled
+  std::function<void()> wake_;     ///< Wakes up a waiting consumer
+  alignas(64) std::atomic<size_t> tail_;  ///< The next cell to fill
+  std::atomic<size_t> signals_;           ///< Events queued elsewhere
+  std::atomic<bool> is_waiting_;          ///< Set while the consumer may block
+};
+
+}  // namespace symmetri
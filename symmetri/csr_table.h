@@ -0,0 +1,178 @@
+#pragma once
+
+/** @file csr_table.h */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+#include "symmetri/colors.hpp"
+
+namespace symmetri {
+
+/**
+ * @brief Arc is a colored arc between a transition and a place, as stored in
+ * the arc tables of a Petri net. The place is a 32 bit index, so an arc takes
+ * 8 bytes.
+ *
+ */
+struct Arc {
+  uint32_t place;  ///< The place as index in the place vector
+  Token color;     ///< The color of the tokens the arc consumes or produces
+
+  bool operator==(const Arc& rhs) const noexcept {
+    return place == rhs.place && color == rhs.color;
+  }
+  bool operator<(const Arc& rhs) const noexcept {
+    return place < rhs.place || (place == rhs.place && color < rhs.color);
+  }
+};
+
+/**
+ * @brief Span is a non-owning view on a contiguous range of elements, e.g. a
+ * row of a CsrTable.
+ *
+ * @tparam T the element type
+ */
+template <typename T>
+class Span {
+ public:
+  constexpr Span() noexcept : first_(nullptr), last_(nullptr) {}
+  constexpr Span(const T* first, size_t count) noexcept
+      : first_(first), last_(first + count) {}
+  Span(const std::vector<T>& elements) noexcept
+      : Span(elements.data(), elements.size()) {}
+  Span(std::initializer_list<T> elements) noexcept
+      : Span(elements.begin(), elements.size()) {}
+
+  const T* begin() const noexcept { return first_; }
+  const T* end() const noexcept { return last_; }
+  size_t size() const noexcept { return static_cast<size_t>(last_ - first_); }
+  bool empty() const noexcept { return first_ == last_; }
+  const T& operator[](size_t i) const noexcept { return first_[i]; }
+
+ private:
+  const T* first_;
+  const T* last_;
+};
+
+/**
+ * @brief CsrTable stores a list of lists in compressed sparse row format: all
+ * elements are stored in one contiguous array, and row r consists of the
+ * elements [offset[r], offset[r + 1]). Compared to a vector of vectors this
+ * needs no allocation per row, and walking consecutive rows is a sequential
+ * scan through memory. The table is immutable after construction, apart from
+ * reordering elements within a row.
+ *
+ * @tparam T the element type
+ */
+template <typename T>
+class CsrTable {
+ public:
+  /**
+   * @brief Construct an empty table with zero rows.
+   *
+   */
+  CsrTable() : offset_{0} {}
+
+  /**
+   * @brief Creates a table from a list of lists. Every element of every row is
+   * converted with `convert`.
+   *
+   * @param rows
+   * @param convert
+   * @return CsrTable
+   */
+  template <typename Rows, typename F>
+  static CsrTable fromRows(const Rows& rows, F&& convert) {
+    CsrTable table;
+    table.offset_.reserve(rows.size() + 1);
+    size_t count = 0;
+    for (const auto& row : rows) {
+      count += row.size();
+    }
+    table.data_.reserve(count);
+    for (const auto& row : rows) {
+      for (const auto& element : row) {
+        table.data_.push_back(convert(element));
+      }
+      table.offset_.push_back(static_cast<uint32_t>(table.data_.size()));
+    }
+    return table;
+  }
+
+  /**
+   * @brief Construct a table with `row_count` rows from (row, element) pairs.
+   * The pairs are grouped by row with a stable counting sort, so elements keep
+   * their relative order within a row.
+   *
+   * @param row_count
+   * @param entries
+   */
+  CsrTable(size_t row_count, const std::vector<std::pair<uint32_t, T>>& entries)
+      : offset_(row_count + 1, 0) {
+    for (const auto& entry : entries) {
+      offset_[entry.first + 1]++;
+    }
+    for (size_t r = 0; r < row_count; r++) {
+      offset_[r + 1] += offset_[r];
+    }
+    // elements need not be default constructible, so the sort computes the
+    // source of every slot instead of writing into a pre-sized array.
+    std::vector<uint32_t> next(offset_.begin(), offset_.end() - 1);
+    std::vector<uint32_t> source(entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+      source[next[entries[i].first]++] = static_cast<uint32_t>(i);
+    }
+    data_.reserve(entries.size());
+    for (const auto i : source) {
+      data_.push_back(entries[i].second);
+    }
+  }
+
+  /**
+   * @brief Get a row of the table.
+   *
+   * @param r
+   * @return Span<T>
+   */
+  Span<T> operator[](size_t r) const noexcept {
+    return {data_.data() + offset_[r], offset_[r + 1] - offset_[r]};
+  }
+
+  /**
+   * @brief The amount of rows.
+   *
+   * @return size_t
+   */
+  size_t size() const noexcept { return offset_.size() - 1; }
+
+  /**
+   * @brief The amount of elements in all rows.
+   *
+   * @return size_t
+   */
+  size_t elementCount() const noexcept { return data_.size(); }
+
+  /**
+   * @brief Sorts the elements of every row.
+   *
+   */
+  void sortRows() {
+    for (size_t r = 0; r + 1 < offset_.size(); r++) {
+      std::sort(data_.begin() + offset_[r], data_.begin() + offset_[r + 1]);
+    }
+  }
+
+ private:
+  std::vector<uint32_t> offset_;  ///< Row r starts at offset_[r]
+  std::vector<T> data_;           ///< The elements of all rows
+};
+
+using ArcTable = CsrTable<Arc>;  ///< Arcs per transition
+
+}  // namespace symmetri
@@ -0,0 +1,144 @@
+#include "dense_marking.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace symmetri {
+
+DenseMarking::DenseMarking(size_t place_count)
+    : place_count_(place_count),
+      size_(0),
+      totals_(place_count, 0),
+      goal_entries_(0),
+      unsatisfied_(0),
+      has_goal_(false),
+      watched_(0),
+      is_dirty_(place_count, 0) {
+  row_.fill(-1);
+}
+
+void DenseMarking::reset(const std::vector<AugmentedToken>& tokens) {
+  std::fill(counts_.begin(), counts_.end(), 0);
+  std::fill(totals_.begin(), totals_.end(), 0);
+  std::fill(occupied_.begin(), occupied_.end(), 0);
+  size_ = 0;
+  // all targets are at least 1, so with an empty marking none are met.
+  unsatisfied_ = goal_entries_;
+  clearDirty();
+  for (const auto& [p, c] : tokens) {
+    if (p < place_count_) {
+      add(p, c);
+    }
+  }
+}
+
+size_t DenseMarking::allocateRow(Token color) {
+  const auto row = colors_.size();
+  row_[color.toIndex()] = static_cast<int16_t>(row);
+  colors_.push_back(color);
+  counts_.resize(counts_.size() + place_count_, 0);
+  targets_.resize(counts_.size(), kNoGoal);
+  watch_.resize(counts_.size(), -1);
+  return row;
+}
+
+size_t DenseMarking::watch(size_t place, Token color) {
+  const auto cell = rowOf(color) * place_count_ + place;
+  if (watch_[cell] < 0) {
+    watch_[cell] = static_cast<int32_t>(watched_++);
+    occupied_.resize((watched_ + 63) / 64, 0);
+    if (counts_[cell] > 0) {
+      const auto bit = static_cast<size_t>(watch_[cell]);
+      occupied_[bit / 64] |= uint64_t{1} << (bit % 64);
+    }
+  }
+  return static_cast<size_t>(watch_[cell]);
+}
+
+void DenseMarking::setGoal(const std::vector<AugmentedToken>& goal) {
+  for (const auto cell : goal_cells_) {
+    targets_[cell] = kNoGoal;
+  }
+  goal_cells_.clear();
+  goal_entries_ = 0;
+  has_goal_ = not goal.empty();
+
+  for (const auto& [p, c] : goal) {
+    if (p >= place_count_) {
+      // this entry can never be met.
+      goal_entries_++;
+      continue;
+    }
+    const auto cell = rowOf(c) * place_count_ + p;
+    if (targets_[cell] == kNoGoal) {
+      targets_[cell] = 1;
+      goal_cells_.push_back(cell);
+      goal_entries_++;
+    } else {
+      targets_[cell]++;
+    }
+  }
+
+  unsatisfied_ = goal_entries_;
+  for (const auto cell : goal_cells_) {
+    unsatisfied_ -= counts_[cell] == targets_[cell];
+  }
+}
+
+bool DenseMarking::canFire(Span<Arc> pre) const noexcept {
+  for (auto it = pre.begin(); it != pre.end();) {
+    const auto& [p, c] = *it;
+    const auto run_end =
+        std::find_if(std::next(it), pre.end(), [it](const auto& arc) {
+          return !(arc == *it);
+        });
+    const auto required = static_cast<uint32_t>(std::distance(it, run_end));
+    // if for any of the inputs there are not sufficient tokens, the transition
+    // can not fire.
+    if (count(p, c) < required) {
+      return false;
+    }
+    it = run_end;
+  }
+
+  // if we did not return early and pre is not empty, it the transition is
+  // fireable.
+  return not pre.empty();
+}
+
+void DenseMarking::deduct(Span<Arc> pre) noexcept {
+  for (const auto& [p, c] : pre) {
+    const auto cell =
+        static_cast<size_t>(row_[c.toIndex()]) * place_count_ + p;
+    const auto target = targets_[cell];
+    unsatisfied_ += counts_[cell] == target;
+    unsatisfied_ -= --counts_[cell] == target;
+    --totals_[p];
+    if (counts_[cell] == 0 && watch_[cell] >= 0) {
+      const auto bit = static_cast<size_t>(watch_[cell]);
+      occupied_[bit / 64] &= ~(uint64_t{1} << (bit % 64));
+    }
+  }
+  size_ -= pre.size();
+}
+
+void DenseMarking::clearDirty() noexcept {
+  for (const auto place : dirty_) {
+    is_dirty_[place] = 0;
+  }
+  dirty_.clear();
+}
+
+std::vector<AugmentedToken> DenseMarking::toTokens() const {
+  std::vector<AugmentedToken> tokens;
+  tokens.reserve(size_);
+  for (size_t row = 0; row < colors_.size(); row++) {
+    for (size_t p = 0; p < place_count_; p++) {
+      tokens.insert(tokens.end(), counts_[row * place_count_ + p],
+                    {p, colors_[row]});
+    }
+  }
+  return tokens;
+}
+
+}  // namespace symmetri
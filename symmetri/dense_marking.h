@@ -0,0 +1,241 @@
+#pragma once
+
+/** @file dense_marking.h */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <tuple>
+#include <vector>
+
+#include "csr_table.h"
+#include "symmetri/colors.hpp"
+
+namespace symmetri {
+
+/**
+ * @brief AugmentedToken describes a token with a color in a
+ * particular place.
+ *
+ */
+using AugmentedToken = std::tuple<size_t, Token>;
+
+/**
+ * @brief DenseMarking stores the marking of a Petri net as token counts,
+ * indexed by (place, color). Every color that has been observed gets its own
+ * row of `place_count` counters in one contiguous array. Checking whether a
+ * transition is enabled, or deducting its pre-conditions, therefore costs
+ * O(arcs) instead of O(tokens x arcs).
+ *
+ * It also keeps track of the places that received tokens (dirty places).
+ * Removing tokens can never enable a transition, so only the consumers of
+ * dirty places have to be re-examined to find newly enabled transitions.
+ *
+ * A goal marking can be compiled into per-(place, color) targets. Every
+ * mutation updates the amount of targets that are not met, so checking whether
+ * the goal is reached is O(1).
+ *
+ * Finally, (place, color) cells can be watched. For every watched cell a bit
+ * in the occupancy bitmap tells whether it holds any tokens, which allows for
+ * bit-parallel enabling checks.
+ *
+ */
+class DenseMarking {
+ public:
+  /**
+   * @brief Construct a new DenseMarking for a net with `place_count` places.
+   * Rows are only allocated for colors that actually occur.
+   *
+   * @param place_count
+   */
+  explicit DenseMarking(size_t place_count = 0);
+
+  /**
+   * @brief Empties the marking and fills it with the given tokens. Tokens in
+   * places outside of the net are ignored. Afterwards, exactly the places that
+   * hold tokens are dirty.
+   *
+   * @param tokens
+   */
+  void reset(const std::vector<AugmentedToken>& tokens);
+
+  /**
+   * @brief Get the amount of tokens with a particular color in a place.
+   *
+   * @param place
+   * @param color
+   * @return uint32_t
+   */
+  uint32_t count(size_t place, Token color) const noexcept {
+    const auto row = row_[color.toIndex()];
+    return row < 0 || place >= place_count_
+               ? 0
+               : counts_[static_cast<size_t>(row) * place_count_ + place];
+  }
+
+  /**
+   * @brief Get the amount of tokens in a place, of any color.
+   *
+   * @param place
+   * @return uint32_t
+   */
+  uint32_t count(size_t place) const noexcept {
+    return place < place_count_ ? totals_[place] : 0;
+  }
+
+  /**
+   * @brief Adds a token of a particular color to a place and marks the place
+   * as dirty.
+   *
+   * @param place
+   * @param color
+   */
+  void add(size_t place, Token color) {
+    const auto cell = rowOf(color) * place_count_ + place;
+    const auto target = targets_[cell];
+    unsatisfied_ += counts_[cell] == target;
+    unsatisfied_ -= ++counts_[cell] == target;
+    if (counts_[cell] == 1 && watch_[cell] >= 0) {
+      const auto bit = static_cast<size_t>(watch_[cell]);
+      occupied_[bit / 64] |= uint64_t{1} << (bit % 64);
+    }
+    ++size_;
+    ++totals_[place];
+    if (is_dirty_[place] == 0) {
+      is_dirty_[place] = 1;
+      dirty_.push_back(place);
+    }
+  }
+
+  /**
+   * @brief Checks if the pre-conditions are met. Duplicate arcs in `pre` must
+   * be adjacent (e.g. `pre` is sorted), so that the required amount of tokens
+   * can be determined in a single pass.
+   *
+   * @param pre vector of preconditions
+   * @return true if the pre-conditions are met
+   * @return false otherwise, or if `pre` is empty
+   */
+  bool canFire(Span<Arc> pre) const noexcept;
+
+  /**
+   * @brief deducts the pre-conditions from the marking. It assumes canFire is
+   * true for `pre`.
+   *
+   * @param pre vector of preconditions
+   */
+  void deduct(Span<Arc> pre) noexcept;
+
+  /**
+   * @brief Compiles the goal marking into targets. The goal is reached if the
+   * marking is equal to `goal` for every colored place that occurs in `goal`.
+   * An empty goal, or a goal with tokens in places outside of the net, is
+   * never reached.
+   *
+   * @param goal
+   */
+  void setGoal(const std::vector<AugmentedToken>& goal);
+
+  /**
+   * @brief Checks if the goal marking is reached.
+   *
+   * @return true
+   * @return false
+   */
+  bool goalReached() const noexcept { return has_goal_ && unsatisfied_ == 0; }
+
+  /**
+   * @brief Watches a (place, color) cell. Its bit in the occupancy bitmap is
+   * set if the cell holds any tokens. Watching the same cell twice returns the
+   * same bit.
+   *
+   * @param place
+   * @param color
+   * @return size_t the index of the bit in the occupancy bitmap
+   */
+  size_t watch(size_t place, Token color);
+
+  /**
+   * @brief Get the occupancy bitmap of the watched cells.
+   *
+   * @return const std::vector<uint64_t>&
+   */
+  const std::vector<uint64_t>& occupied() const noexcept { return occupied_; }
+
+  /**
+   * @brief Get the places that received tokens since the last call to
+   * clearDirty.
+   *
+   * @return const std::vector<size_t>&
+   */
+  const std::vector<size_t>& dirtyPlaces() const noexcept { return dirty_; }
+
+  /**
+   * @brief Forget about all dirty places.
+   *
+   */
+  void clearDirty() noexcept;
+
+  /**
+   * @brief outputs the marking as a vector of tokens; every token is a
+   * separate entry.
+   *
+   * @return std::vector<AugmentedToken>
+   */
+  std::vector<AugmentedToken> toTokens() const;
+
+  /**
+   * @brief The total amount of tokens in the marking.
+   *
+   * @return size_t
+   */
+  size_t size() const noexcept { return size_; }
+
+  /**
+   * @brief The amount of places the marking is made for.
+   *
+   * @return size_t
+   */
+  size_t placeCount() const noexcept { return place_count_; }
+
+ private:
+  /**
+   * @brief Get the row of a color, allocating it if the color was not seen
+   * before.
+   *
+   * @param color
+   * @return size_t
+   */
+  size_t rowOf(Token color) {
+    const auto row = row_[color.toIndex()];
+    return row < 0 ? allocateRow(color) : static_cast<size_t>(row);
+  }
+  size_t allocateRow(Token color);
+
+  /**
+   * @brief The target of cells that are not part of the goal; no count can
+   * ever be equal to it.
+   *
+   */
+  static constexpr uint32_t kNoGoal = UINT32_MAX;
+
+  size_t place_count_;              ///< The amount of places in the net
+  size_t size_;                     ///< The total amount of tokens
+  std::array<int16_t, 256> row_;    ///< Row in counts_ per color, -1 if none
+  std::vector<Token> colors_;       ///< The color of every allocated row
+  std::vector<uint32_t> counts_;    ///< Token counts, indexed [row][place]
+  std::vector<uint32_t> totals_;    ///< Token counts of any color, by place
+  std::vector<uint32_t> targets_;   ///< Goal counts, indexed like counts_
+  std::vector<size_t> goal_cells_;  ///< The indices of the goal in targets_
+  size_t goal_entries_;             ///< Amount of distinct goal entries
+  size_t unsatisfied_;              ///< Amount of goal entries that are unmet
+  bool has_goal_;                   ///< False if the goal is empty
+  std::vector<int32_t> watch_;      ///< Occupancy bit per cell, -1 if none
+  std::vector<uint64_t> occupied_;  ///< Occupancy bitmap of watched cells
+  size_t watched_;                  ///< The amount of watched cells
+  std::vector<size_t> dirty_;       ///< Places that received tokens
+  std::vector<uint8_t> is_dirty_;   ///< 1 if a place is in dirty_
+};
+
+}  // namespace symmetri
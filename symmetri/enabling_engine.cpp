@@ -0,0 +1,145 @@
+#include "enabling_engine.h"
+
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "bits.h"
+
+namespace symmetri {
+namespace {
+
+/**
+ * @brief clears the bits of `consumers` in `enabled`, e.g. enabled &=
+ * ~consumers, using the widest available vector instructions.
+ *
+ */
+void clearConsumers(uint64_t* enabled, const uint64_t* consumers,
+                    size_t words) noexcept {
+  size_t i = 0;
+#if defined(__AVX512F__)
+  for (; i + 8 <= words; i += 8) {
+    const auto e = _mm512_loadu_si512(enabled + i);
+    const auto c = _mm512_loadu_si512(consumers + i);
+    // unlike _mm512_andnot_si512, the zero-masked variant does not trigger a
+    // false maybe-uninitialized warning in GCC.
+    _mm512_storeu_si512(enabled + i, _mm512_maskz_andnot_epi64(0xFF, c, e));
+  }
+#endif
+#if defined(__AVX2__)
+  for (; i + 4 <= words; i += 4) {
+    const auto e = _mm256_loadu_si256(reinterpret_cast<__m256i*>(enabled + i));
+    const auto c =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(consumers + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(enabled + i),
+                        _mm256_andnot_si256(c, e));
+  }
+#endif
+#if defined(__SSE2__)
+  for (; i + 2 <= words; i += 2) {
+    const auto e = _mm_loadu_si128(reinterpret_cast<__m128i*>(enabled + i));
+    const auto c =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(consumers + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(enabled + i),
+                     _mm_andnot_si128(c, e));
+  }
+#endif
+  for (; i < words; i++) {
+    enabled[i] &= ~consumers[i];
+  }
+}
+
+}  // namespace
+
+bool EnablingEngine::isBitParallel(const ArcTable& input_n) noexcept {
+  for (size_t t = 0; t < input_n.size(); t++) {
+    // the inputs are sorted, so duplicate arcs are adjacent.
+    const auto pre = input_n[t];
+    if (std::adjacent_find(pre.begin(), pre.end()) != pre.end()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+EnablingEngine::EnablingEngine(const ArcTable& input_n)
+    : mask_offset_{0},
+      words_((input_n.size() + 63) / 64),
+      has_inputs_(words_, 0) {
+  std::unordered_map<uint64_t, uint32_t> cell_of;
+  const auto cell = [&](const Arc& arc) {
+    const auto key = (uint64_t{arc.place} << 8) | arc.color.toIndex();
+    const auto [it, is_new] =
+        cell_of.emplace(key, static_cast<uint32_t>(cells_.size()));
+    if (is_new) {
+      cells_.push_back(arc);
+    }
+    return it->second;
+  };
+
+  std::vector<uint32_t> cells;
+  for (size_t t = 0; t < input_n.size(); t++) {
+    const auto first_mask = mask_word_.size();
+    for (const auto& arc : input_n[t]) {
+      const auto c = cell(arc);
+      cells.push_back(c);
+      const auto word = c / 64;
+      auto it = std::find(std::next(mask_word_.begin(), first_mask),
+                          mask_word_.end(), word);
+      if (it == mask_word_.end()) {
+        mask_word_.push_back(word);
+        mask_bits_.push_back(0);
+        it = std::prev(mask_word_.end());
+      }
+      mask_bits_[std::distance(mask_word_.begin(), it)] |= uint64_t{1}
+                                                           << (c % 64);
+    }
+    mask_offset_.push_back(static_cast<uint32_t>(mask_word_.size()));
+    if (!input_n[t].empty()) {
+      has_inputs_[t / 64] |= uint64_t{1} << (t % 64);
+    }
+  }
+
+  if (cells_.size() * words_ <= kMaxBulkWords) {
+    consumers_.assign(cells_.size() * words_, 0);
+    auto c = cells.begin();
+    for (size_t t = 0; t < input_n.size(); t++) {
+      for (size_t i = 0; i < input_n[t].size(); i++, c++) {
+        consumers_[*c * words_ + t / 64] |= uint64_t{1} << (t % 64);
+      }
+    }
+  }
+}
+
+void EnablingEngine::watch(DenseMarking& tokens) const {
+  // a fresh marking numbers the cells in the order they are watched.
+  for (const auto& [p, c] : cells_) {
+    tokens.watch(p, c);
+  }
+}
+
+void EnablingEngine::enabledTransitions(const DenseMarking& tokens,
+                                        std::vector<uint64_t>& enabled) const {
+  enabled = has_inputs_;
+  const auto& occupied = tokens.occupied();
+  const auto cell_count = cells_.size();
+  // every empty cell disables all of its consumers.
+  for (size_t w = 0; w * 64 < cell_count; w++) {
+    uint64_t empty = ~occupied[w];
+    if (cell_count - w * 64 < 64) {
+      empty &= (uint64_t{1} << (cell_count - w * 64)) - 1;
+    }
+    while (empty != 0) {
+      const auto cell = w * 64 + lowestBit(empty);
+      empty &= empty - 1;
+      clearConsumers(enabled.data(), consumers_.data() + cell * words_,
+                     words_);
+    }
+  }
+}
+
+}  // namespace symmetri
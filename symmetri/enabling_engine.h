@@ -0,0 +1,140 @@
+#pragma once
+
+/** @file enabling_engine.h */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "dense_marking.h"
+
+namespace symmetri {
+
+/**
+ * @brief EnablingEngine decides whether transitions are enabled. If every
+ * input arc of the net has weight one, which is the case for 1-safe control
+ * nets, a transition is enabled if and only if all its input (place, color)
+ * cells hold a token. The engine then watches these cells in the marking and
+ * compares packed bitmaps instead of walking the input tuples:
+ *
+ * - A single transition is checked with one AND/compare per 64 cells, because
+ *   the cells of a transition are numbered consecutively.
+ * - All transitions can be evaluated at once on a transposed (cell x
+ *   transition) bitmap, 64 to 512 transitions per instruction depending on the
+ *   available SIMD extension (AVX-512, AVX2, SSE2 or plain 64 bit words).
+ *
+ * For other nets, the engine falls back to the generic count-based check of
+ * DenseMarking.
+ *
+ * The engine only depends on the structure of the net, so it can be shared by
+ * all instances of the net. Every marking it is used with must watch the cells
+ * of the engine first.
+ *
+ */
+class EnablingEngine {
+ public:
+  /**
+   * @brief Checks if the bit-parallel engine can be used for the net; e.g.
+   * none of the transitions has duplicate input arcs.
+   *
+   * @param input_n the inputs of every transition, sorted
+   * @return true
+   * @return false
+   */
+  static bool isBitParallel(const ArcTable& input_n) noexcept;
+
+  /**
+   * @brief Construct an engine that uses the generic check.
+   *
+   */
+  EnablingEngine() = default;
+
+  /**
+   * @brief Construct a bit-parallel engine. The input cells of the net are
+   * numbered in order of appearance. isBitParallel(input_n) must be true.
+   *
+   * @param input_n the inputs of every transition, sorted
+   */
+  explicit EnablingEngine(const ArcTable& input_n);
+
+  /**
+   * @brief Watches the input cells of the net in `tokens`, so that the bits of
+   * its occupancy bitmap match the cell numbering of the engine. `tokens` may
+   * not watch any other cells. Does nothing for the generic engine.
+   *
+   * @param tokens the marking that is used for the enabling checks
+   */
+  void watch(DenseMarking& tokens) const;
+
+  /**
+   * @brief Checks if the engine is bit-parallel.
+   *
+   * @return true
+   * @return false
+   */
+  bool isBitParallel() const noexcept { return !mask_offset_.empty(); }
+
+  /**
+   * @brief Checks if the bulk evaluation of enabledTransitions is available.
+   * Its cost grows with (empty cells x transitions), so the transposed bitmap
+   * is only built for small nets. For larger nets checking the transitions one
+   * by one is faster.
+   *
+   * @return true
+   * @return false
+   */
+  bool hasBulk() const noexcept { return !consumers_.empty(); }
+
+  /**
+   * @brief Checks if transition t is enabled.
+   *
+   * @param t transition as index in transition vector
+   * @param pre the inputs of t, used by the generic check
+   * @param tokens the current marking
+   * @return true if the pre-conditions are met
+   * @return false otherwise
+   */
+  bool canFire(size_t t, Span<Arc> pre,
+               const DenseMarking& tokens) const noexcept {
+    if (!isBitParallel()) {
+      return tokens.canFire(pre);
+    }
+    const auto& occupied = tokens.occupied();
+    const auto begin = mask_offset_[t];
+    const auto end = mask_offset_[t + 1];
+    for (auto i = begin; i < end; i++) {
+      if ((occupied[mask_word_[i]] & mask_bits_[i]) != mask_bits_[i]) {
+        return false;
+      }
+    }
+    return begin != end;
+  }
+
+  /**
+   * @brief Evaluates all transitions at once. Only available if hasBulk().
+   *
+   * @param tokens the current marking
+   * @param enabled a bitmap in which bit t is set if transition t is enabled
+   */
+  void enabledTransitions(const DenseMarking& tokens,
+                          std::vector<uint64_t>& enabled) const;
+
+ private:
+  /**
+   * @brief The maximum size of the transposed bitmap, in 64 bit words (128
+   * KiB).
+   *
+   */
+  static constexpr size_t kMaxBulkWords = size_t{1} << 14;
+
+  std::vector<Arc> cells_;             ///< The (place, color) of every cell
+  std::vector<uint32_t> mask_offset_;  ///< Masks of t start at offset[t]
+  std::vector<uint32_t> mask_word_;    ///< The word in the occupancy bitmap
+  std::vector<uint64_t> mask_bits_;    ///< The cells of t in that word
+  size_t words_ = 0;                   ///< Words in a transition bitmap
+  std::vector<uint64_t> has_inputs_;   ///< Bit t is set if t has inputs
+  std::vector<uint64_t> consumers_;    ///< Transitions per cell, [cell][word]
+};
+
+}  // namespace symmetri
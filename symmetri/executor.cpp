@@ -0,0 +1,183 @@
+#include "symmetri/executor.h"
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+
+#include "affinity.h"
+#include "externals/blockingconcurrentqueue.h"
+#include "petri.h"
+#include "ring.h"
+
+namespace symmetri {
+
+/**
+ * @brief Run is a PetriNet that is driven by the Executor. It lives from
+ * submit until the run finishes.
+ *
+ */
+struct Executor::Run {
+  Petri *petri;               ///< The net that is run
+  std::atomic<size_t> loop;   ///< The loop that drives it next
+  Continuation continuation;  ///< Receives the result of the run
+};
+
+/**
+ * @brief Loop is the ready-list of a loop thread. A loop that has no runs
+ * announces that it waits with `is_idle`, looks once more, and then waits on
+ * its semaphore. A producer that takes the announcement after queueing a run
+ * signals the semaphore, so a run is never missed and a busy loop is never
+ * signalled.
+ *
+ */
+struct alignas(64) Executor::Loop {
+  std::mutex mutex;                            ///< Guards ready
+  Ring<Run *> ready;                           ///< The runs that have events
+  std::atomic<size_t> queued{0};               ///< The amount of ready runs
+  std::atomic<size_t> load{0};                 ///< The amount of runs
+  std::atomic<bool> is_idle{false};            ///< Set while the loop waits
+  moodycamel::LightweightSemaphore available;  ///< Wakes the loop
+};
+
+Executor::Executor(size_t loop_count, const std::string &name)
+    : loops_(std::make_unique<Loop[]>(std::max<size_t>(loop_count, 1))),
+      loop_count_(std::max<size_t>(loop_count, 1)),
+      name_(name),
+      is_stopping_(false) {
+  for (size_t i = 0; i < loop_count_; i++) {
+    threads_.emplace_back(&Executor::loop, this, i);
+  }
+}
+
+Executor::~Executor() noexcept {
+  is_stopping_.store(true);
+  for (size_t i = 0; i < loop_count_; i++) {
+    if (loops_[i].is_idle.exchange(false)) {
+      loops_[i].available.signal();
+    }
+  }
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+std::future<Token> Executor::submit(const PetriNet &net) {
+  auto result = std::make_shared<std::promise<Token>>();
+  auto future = result->get_future();
+  submit(net, [result](Token token) { result->set_value(token); });
+  return future;
+}
+
+void Executor::submit(const PetriNet &net, Continuation continuation) {
+  auto &m = *net.impl;
+  if (m.thread_id_.load().has_value()) {
+    continuation(Failed);
+    return;
+  }
+  m.thread_id_.store(getThreadId());
+
+  const auto first = std::min_element(
+      loops_.get(), loops_.get() + loop_count_,
+      [](const Loop &a, const Loop &b) { return a.load < b.load; });
+  first->load++;
+  auto run = new Run{&m, static_cast<size_t>(first - loops_.get()),
+                     std::move(continuation)};
+  m.continuation = [this, run](Token result) {
+    loops_[run->loop].load--;
+    auto done = std::move(run->continuation);
+    delete run;
+    done(result);
+  };
+  m.start(true);
+  // the run is driven by the loops, instead of by the threadpool.
+  m.completion_queue->setWake([this, run] { schedule(run); });
+  schedule(run);
+}
+
+std::vector<size_t> Executor::getLoad() const {
+  std::vector<size_t> load(loop_count_);
+  for (size_t i = 0; i < loop_count_; i++) {
+    load[i] = loops_[i].load;
+  }
+  return load;
+}
+
+void Executor::schedule(Run *run) {
+  auto index = run->loop.load();
+  // a run that would queue behind others moves to an idle loop, if any.
+  if (loops_[index].queued > 0) {
+    for (size_t i = 1; i < loop_count_; i++) {
+      const auto other = (index + i) % loop_count_;
+      if (loops_[other].is_idle) {
+        loops_[index].load--;
+        loops_[other].load++;
+        index = other;
+        run->loop.store(other);
+        break;
+      }
+    }
+  }
+
+  auto &target = loops_[index];
+  {
+    std::lock_guard<std::mutex> lock(target.mutex);
+    target.ready.pushBack(std::move(run));
+    target.queued++;
+  }
+  if (target.is_idle.exchange(false)) {
+    target.available.signal();
+  }
+}
+
+Executor::Run *Executor::take(size_t index) {
+  {
+    auto &self = loops_[index];
+    std::lock_guard<std::mutex> lock(self.mutex);
+    if (!self.ready.empty()) {
+      self.queued--;
+      return self.ready.popFront();
+    }
+  }
+  for (size_t i = 1; i < loop_count_; i++) {
+    const auto victim = (index + i) % loop_count_;
+    auto &other = loops_[victim];
+    std::unique_lock<std::mutex> lock(other.mutex, std::try_to_lock);
+    if (lock.owns_lock() && !other.ready.empty()) {
+      other.queued--;
+      // the oldest run has waited the longest; it moves to this loop.
+      auto run = other.ready.popFront();
+      other.load--;
+      loops_[index].load++;
+      run->loop.store(index);
+      return run;
+    }
+  }
+  return nullptr;
+}
+
+void Executor::loop(size_t index) {
+  setCurrentThreadName(name_ + "-" + std::to_string(index));
+  auto &self = loops_[index];
+  while (!is_stopping_) {
+    auto run = take(index);
+    if (run == nullptr) {
+      // a run that is queued after the announcement signals the loop.
+      self.is_idle.store(true);
+      run = take(index);
+      if (run == nullptr) {
+        if (!is_stopping_) {
+          self.available.wait();
+        }
+        self.is_idle.store(false);
+        continue;
+      }
+      if (!self.is_idle.exchange(false)) {
+        // a producer took the announcement; it has signalled the loop.
+        self.available.wait();
+      }
+    }
+    run->petri->drive();
+  }
+}
+
+}  // namespace symmetri
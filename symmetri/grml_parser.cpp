@@ -1,6 +1,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <limits>
 #include <map>
 #include <set>
 #include <stdexcept>
@@ -19,10 +20,42 @@ using namespace tinyxml2;
 
 namespace symmetri {
 
-std::tuple<Net, Marking, PriorityTable> readGrml(
-    const std::set<std::string> &files) {
+namespace {
+
+/**
+ * @brief Converts the text of a bound to a number. It throws if the text is
+ * missing, or is not a whole number that fits in 32 bits.
+ *
+ */
+uint32_t toBound(const char *text, const std::string& what) {
+  const std::string value = text == nullptr ? "" : text;
+  if (value.empty() ||
+      value.find_first_not_of("0123456789") != std::string::npos ||
+      value.size() > 10 ||
+      std::stoull(value) > std::numeric_limits<uint32_t>::max()) {
+    throw std::runtime_error("error: " + what +
+                             " is not a number from 0 to 4294967295: \"" +
+                             value + "\".");
+  }
+  return static_cast<uint32_t>(std::stoull(value));
+}
+
+uint32_t readBound(XMLElement *attribute, const std::string &name) {
+  const auto outer = attribute->FirstChildElement("attribute");
+  const auto inner =
+      outer == nullptr ? nullptr : outer->FirstChildElement("attribute");
+  return toBound(inner == nullptr ? nullptr : inner->GetText(),
+                 "the " + std::string(attribute->Attribute("name")) + " of " +
+                     name);
+}
+
+}  // namespace
+
+std::tuple<Net, Marking, PriorityTable, BoundTable, BoundTable>
+readGrmlWithBounds(const std::set<std::string> &files) {
   std::set<std::string> places, transitions;
   PriorityTable priorities;
+  BoundTable max_in_flight, capacities;
   std::map<int, std::string> id_lookup_table;
 
   Marking place_initialMarking;
@@ -41,6 +74,7 @@ std::tuple<Net, Marking, PriorityTable> readGrml(
         // loop places & initial values
         std::string place_id;
         uint16_t initial_marking = 0;
+        uint32_t capacity = 0;
         for (XMLElement *attribute = child->FirstChildElement("attribute");
              attribute != NULL;
              attribute = attribute->NextSiblingElement("attribute")) {
@@ -53,6 +87,8 @@ std::tuple<Net, Marking, PriorityTable> readGrml(
                 std::stoi(attribute->FirstChildElement("attribute")
                               ->FirstChildElement("attribute")
                               ->GetText());
+          } else if (child_attribute == "capacity") {
+            capacity = readBound(attribute, place_id);
           }
         }
         for (int i = 0; i < initial_marking; i++) {
@@ -60,10 +96,14 @@ std::tuple<Net, Marking, PriorityTable> readGrml(
         }
         places.insert(place_id);
         id_lookup_table.insert({id, place_id});
+        if (capacity != 0) {
+          capacities.push_back({place_id, capacity});
+        }
       } else if (type == "transition") {
         // loop transitions
         std::string transition_id;
         int8_t priority = 0;
+        uint32_t limit = 0;
         for (XMLElement *attribute = child->FirstChildElement("attribute");
              attribute != NULL;
              attribute = attribute->NextSiblingElement("attribute")) {
@@ -75,6 +115,8 @@ std::tuple<Net, Marking, PriorityTable> readGrml(
             priority = std::stoi(attribute->FirstChildElement("attribute")
                                      ->FirstChildElement("attribute")
                                      ->GetText());
+          } else if (child_attribute == "maxInFlight") {
+            limit = readBound(attribute, transition_id);
           }
         }
         transitions.insert(transition_id);
@@ -82,6 +124,9 @@ std::tuple<Net, Marking, PriorityTable> readGrml(
         if (priority != 0) {
           priorities.push_back({transition_id, priority});
         }
+        if (limit != 0) {
+          max_in_flight.push_back({transition_id, limit});
+        }
       }
     }
     for (XMLElement *child = levelElement->FirstChildElement("arc");
@@ -123,7 +168,15 @@ std::tuple<Net, Marking, PriorityTable> readGrml(
     }
   }
 
-  return {state_net, place_initialMarking, priorities};
+  return {state_net, place_initialMarking, priorities, max_in_flight,
+          capacities};
+}
+
+std::tuple<Net, Marking, PriorityTable> readGrml(
+    const std::set<std::string> &files) {
+  auto [net, m0, priorities, max_in_flight, capacities] =
+      readGrmlWithBounds(files);
+  return {std::move(net), std::move(m0), std::move(priorities)};
 }
 
 }  // namespace symmetri
@@ -0,0 +1,208 @@
+#include "symmetri/histogram.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace symmetri {
+
+void Histogram::merge(const Histogram& other) {
+  if (other.count_ == 0) {
+    return;
+  }
+  if (chunks_.empty()) {
+    chunks_.resize(other.chunks_.size());
+  }
+  for (size_t c = 0; c < chunks_.size(); c++) {
+    const auto& from = other.chunks_[c];
+    if (from.empty()) {
+      continue;
+    }
+    auto& to = chunks_[c];
+    if (to.empty()) {
+      to = from;
+      continue;
+    }
+    for (size_t i = 0; i < from.size(); i++) {
+      to[i] += from[i];
+    }
+  }
+  count_ += other.count_;
+  sum_ += other.sum_;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+}
+
+uint64_t Histogram::upperBound(size_t bucket) noexcept {
+  if (bucket < exact_values) {
+    return bucket;
+  }
+  const size_t octave = (bucket - exact_values) >> sub_bucket_bits;
+  const size_t shift = octave + 6 - sub_bucket_bits;
+  const uint64_t sub = (bucket - exact_values) % (size_t(1) << sub_bucket_bits);
+  return (((uint64_t(1) << sub_bucket_bits) + sub + 1) << shift) - 1;
+}
+
+uint64_t Histogram::percentile(double percentile) const noexcept {
+  if (count_ == 0) {
+    return 0;
+  }
+  const auto fraction = std::clamp(percentile, 0.0, 100.0) / 100.0;
+  const auto rank = std::clamp<uint64_t>(
+      static_cast<uint64_t>(std::ceil(fraction * double(count_))), 1, count_);
+  uint64_t seen = 0;
+  for (size_t b = 0; b < bucket_count; b++) {
+    seen += bucket(b);
+    if (seen >= rank) {
+      return std::clamp(upperBound(b), min_, max_);
+    }
+  }
+  return max_;
+}
+
+uint64_t Histogram::countAtMost(uint64_t value) const noexcept {
+  if (value >= max_) {
+    return count_;
+  }
+  uint64_t seen = 0;
+  for (size_t b = 0; b < bucket_count && upperBound(b) <= value; b++) {
+    seen += bucket(b);
+  }
+  return seen;
+}
+
+namespace {
+
+std::string quote(std::string_view s) {
+  std::string quoted = "\"";
+  for (const auto c : s) {
+    if (c == '"' || c == '\\') {
+      quoted.push_back('\\');
+      quoted.push_back(c);
+    } else if (c == '\n') {
+      quoted += "\\n";
+    } else {
+      quoted.push_back(c);
+    }
+  }
+  quoted.push_back('"');
+  return quoted;
+}
+
+void writeJson(std::ostream& out, const Histogram& h) {
+  out << "{\"count\":" << h.count() << ",\"sum\":" << h.sum()
+      << ",\"min\":" << h.min() << ",\"max\":" << h.max()
+      << ",\"mean\":" << h.mean() << ",\"p50\":" << h.percentile(50)
+      << ",\"p90\":" << h.percentile(90) << ",\"p99\":" << h.percentile(99)
+      << ",\"p999\":" << h.percentile(99.9) << ",\"buckets\":[";
+  bool is_first = true;
+  for (size_t b = 0; b < Histogram::bucket_count; b++) {
+    if (h.bucket(b) != 0) {
+      out << (is_first ? "" : ",") << '[' << Histogram::upperBound(b) << ','
+          << h.bucket(b) << ']';
+      is_first = false;
+    }
+  }
+  out << "]}";
+}
+
+// the bucket bounds of the Prometheus histograms in nanoseconds: 1, 2.5 and 5
+// times every power of ten from 1 us to 100 s.
+constexpr std::array<uint64_t, 25> prometheus_bounds = {
+    1000,        2500,        5000,        10000,        25000,
+    50000,       100000,      250000,      500000,       1000000,
+    2500000,     5000000,     10000000,    25000000,     50000000,
+    100000000,   250000000,   500000000,   1000000000,   2500000000,
+    5000000000,  10000000000, 25000000000, 50000000000,  100000000000};
+
+void writePrometheus(std::ostream& out, const Latencies& latencies,
+                     const char* name, const char* help,
+                     Histogram TransitionLatencies::*histogram) {
+  const std::string metric = std::string("symmetri_transition_") + name;
+  out << "# HELP " << metric << ' ' << help << '\n';
+  out << "# TYPE " << metric << " histogram\n";
+  for (const auto& t : latencies.transitions) {
+    const auto& h = t.*histogram;
+    if (h.count() == 0) {
+      continue;
+    }
+    const auto labels = "case_id=" + quote(latencies.case_id) +
+                        ",transition=" + quote(t.transition);
+    for (const auto bound : prometheus_bounds) {
+      out << metric << "_bucket{" << labels << ",le=\"" << double(bound) / 1e9
+          << "\"} " << h.countAtMost(bound) << '\n';
+    }
+    out << metric << "_bucket{" << labels << ",le=\"+Inf\"} " << h.count()
+        << '\n';
+    out << metric << "_sum{" << labels << "} " << double(h.sum()) / 1e9
+        << '\n';
+    out << metric << "_count{" << labels << "} " << h.count() << '\n';
+  }
+}
+
+}  // namespace
+
+std::string writeLatenciesJson(const Latencies& latencies) {
+  std::ostringstream out;
+  out.precision(12);
+  out << "{\"case_id\":" << quote(latencies.case_id)
+      << ",\"unit\":\"ns\",\"transitions\":[";
+  for (size_t i = 0; i < latencies.transitions.size(); i++) {
+    const auto& t = latencies.transitions[i];
+    out << (i == 0 ? "" : ",") << "{\"transition\":" << quote(t.transition)
+        << ",\"queueing\":";
+    writeJson(out, t.queueing);
+    out << ",\"service\":";
+    writeJson(out, t.service);
+    out << ",\"delivery\":";
+    writeJson(out, t.delivery);
+    out << '}';
+  }
+  out << "]}";
+  return out.str();
+}
+
+std::string writeLatenciesPrometheus(const Latencies& latencies) {
+  std::ostringstream out;
+  out.precision(12);
+  writePrometheus(out, latencies, "queueing_seconds",
+                  "Time from scheduling a transition until its Callback "
+                  "started.",
+                  &TransitionLatencies::queueing);
+  writePrometheus(out, latencies, "service_seconds",
+                  "Time from the start until the end of a Callback.",
+                  &TransitionLatencies::service);
+  writePrometheus(out, latencies, "delivery_seconds",
+                  "Time from the end of a Callback until the event loop "
+                  "applied its result.",
+                  &TransitionLatencies::delivery);
+  return out.str();
+}
+
+bool writeLatenciesPrometheusFile(const Latencies& latencies,
+                                  const std::string& path) {
+  const auto staged = path + ".tmp";
+  {
+    std::ofstream file(staged, std::ios::trunc);
+    file << writeLatenciesPrometheus(latencies);
+    file.close();
+    if (!file) {
+      std::remove(staged.c_str());
+      return false;
+    }
+  }
+  if (std::rename(staged.c_str(), path.c_str()) != 0) {
+    std::remove(staged.c_str());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace symmetri
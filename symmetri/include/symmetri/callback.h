@@ -2,8 +2,11 @@
 
 /** @file callback.h */
 
-#include <atomic>
+#include <functional>
+#include <future>
 #include <memory>
+#include <type_traits>
+#include <utility>
 
 #include "symmetri/types.h"
 
@@ -73,6 +76,53 @@ Token fire(const T &callback) {
   }
 }
 
+/**
+ * @brief Fires a Callback whose invocation returns a suspendable object, such
+ * as a coroutine, by firing that object.
+ *
+ * @tparam T the type of the callback.
+ * @param callback The function to be executed.
+ * @param continuation receives the result.
+ */
+template <typename T>
+auto fire(const T &callback, Continuation continuation)
+    -> decltype(fire(callback(), std::move(continuation))) {
+  return fire(callback(), std::move(continuation));
+}
+
+/**
+ * @brief Checks if a Callback is suspendable, which it is if there is a
+ * `void fire(const T&, Continuation)` for it. A suspendable Callback does not
+ * return its result, but starts its work and passes the result to the
+ * Continuation later, e.g. when a nested net finishes or I/O completes. In the
+ * meantime it does not occupy a thread of the TaskSystem.
+ *
+ * @tparam T the type of the callback.
+ */
+template <typename T, typename = void>
+struct is_suspendable : std::false_type {};
+
+template <typename T>
+struct is_suspendable<T, std::void_t<decltype(fire(
+                             std::declval<const T &>(),
+                             std::declval<Continuation>()))>>
+    : std::true_type {};
+
+/**
+ * @brief Checks if a suspendable Callback is a nested net. A nested net is
+ * started right away by the event loop of its parent, instead of on the
+ * TaskSystem, and it runs as a sub-state of that loop: its events are
+ * processed by the thread of the parent. By default Callbacks are not nested.
+ *
+ * @tparam T the type of the callback.
+ * @return true if the callback runs on the loop of its parent
+ * @return false otherwise
+ */
+template <typename T>
+bool isNested(const T &) {
+  return false;
+}
+
 /**
  * @brief Get the Log object. By default it returns an empty vector.
  *
@@ -124,6 +174,15 @@ class Callback {
   friend Token fire(const Callback &callback) {
     return callback.self_->fire_();
   }
+  friend void fire(const Callback &callback, Continuation continuation) {
+    return callback.self_->fire_(std::move(continuation));
+  }
+  friend bool isSuspendable(const Callback &callback) {
+    return callback.self_->is_suspendable_();
+  }
+  friend bool isNested(const Callback &callback) {
+    return callback.self_->is_nested_();
+  }
   friend Eventlog getLog(const Callback &callback) {
     return callback.self_->get_log_();
   }
@@ -139,20 +198,30 @@ class Callback {
   friend void resume(const Callback &callback) {
     return callback.self_->resume_();
   }
-  auto getEndTime() const {
-    return self_->end_t_.load(std::memory_order_relaxed);
+
+  /**
+   * @brief Get a Callback that shares the state of `callback`. It keeps the
+   * state alive, also when `callback` is replaced or destroyed.
+   *
+   * @param callback
+   * @return Callback
+   */
+  friend Callback share(const Callback &callback) {
+    return Callback(callback.self_);
   }
 
  private:
   struct concept_t {
     virtual ~concept_t() = default;
     virtual Token fire_() const = 0;
+    virtual void fire_(Continuation continuation) const = 0;
+    virtual bool is_suspendable_() const = 0;
+    virtual bool is_nested_() const = 0;
     virtual Eventlog get_log_() const = 0;
     virtual void cancel_() const = 0;
     virtual void pause_() const = 0;
     virtual void resume_() const = 0;
     virtual bool is_synchronous_() const = 0;
-    mutable std::atomic<Clock::time_point> end_t_{Clock::time_point::min()};
   };
 
   /**
@@ -169,9 +238,32 @@ class Callback {
     model(Args &&...args) : transition_(std::forward<Args>(args)...) {}
 
     Token fire_() const override {
-      auto res = fire(transition_);
-      end_t_.store(Clock::now(), std::memory_order_relaxed);
-      return res;
+      if constexpr (is_suspendable<Transition>::value) {
+        // waits for the Continuation of a suspendable Callback.
+        std::promise<Token> result;
+        auto future_result = result.get_future();
+        fire(transition_, [&result](Token t) { result.set_value(t); });
+        return future_result.get();
+      } else {
+        return fire(transition_);
+      }
+    }
+    void fire_(Continuation continuation) const override {
+      if constexpr (is_suspendable<Transition>::value) {
+        fire(transition_, std::move(continuation));
+      } else {
+        continuation(fire_());
+      }
+    }
+    bool is_suspendable_() const override {
+      return is_suspendable<Transition>::value;
+    }
+    bool is_nested_() const override {
+      if constexpr (is_suspendable<Transition>::value) {
+        return isNested(transition_);
+      } else {
+        return false;
+      }
     }
     Eventlog get_log_() const override { return getLog(transition_); }
     void cancel_() const override { return cancel(transition_); }
@@ -181,6 +273,9 @@ class Callback {
     Transition transition_;
   };
 
+  explicit Callback(std::shared_ptr<const concept_t> self)
+      : self_(std::move(self)) {}
+
   std::shared_ptr<const concept_t> self_;
 };
 
@@ -171,3 +171,4 @@ CREATE_CUSTOM_TOKEN(Canceled)
 CREATE_CUSTOM_TOKEN(Paused)
 CREATE_CUSTOM_TOKEN(Failed)
 CREATE_CUSTOM_TOKEN(Cancel)
+CREATE_CUSTOM_TOKEN(TimedOut)
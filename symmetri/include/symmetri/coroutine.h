@@ -0,0 +1,126 @@
+#pragma once
+
+/** @file coroutine.h */
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <coroutine>
+#include <utility>
+
+#include "symmetri/callback.h"
+#include "symmetri/types.h"
+
+namespace symmetri {
+
+/**
+ * @brief Async is the return type of a Callback that is a C++20 coroutine. A
+ * Callback that returns Async is suspendable: the coroutine starts on the
+ * threadpool, and whenever it awaits another suspendable Callback, such as a
+ * nested PetriNet, it gives its thread back. The Token it co_returns is the
+ * result of the transition.
+ *
+ * @code
+ * net.registerCallback("t", [&child]() -> Async {
+ *   const auto result = co_await await(child);
+ *   co_return result;
+ * });
+ * @endcode
+ *
+ */
+class Async {
+ public:
+  struct promise_type {
+    Token result = Scheduled;    ///< The Token that is co_returned
+    Continuation continuation;  ///< Receives the result when done
+
+    Async get_return_object() noexcept {
+      return Async(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    auto final_suspend() noexcept {
+      struct Finish {
+        bool await_ready() noexcept { return false; }
+        void await_suspend(
+            std::coroutine_handle<promise_type> coroutine) noexcept {
+          auto done = std::move(coroutine.promise().continuation);
+          const auto result = coroutine.promise().result;
+          coroutine.destroy();
+          done(result);
+        }
+        void await_resume() noexcept {}
+      };
+      return Finish{};
+    }
+    void return_value(Token token) noexcept { result = token; }
+    void unhandled_exception() noexcept { result = Failed; }
+  };
+
+  Async(Async&& other) noexcept
+      : coroutine_(std::exchange(other.coroutine_, nullptr)) {}
+  Async(const Async&) = delete;
+  Async& operator=(const Async&) = delete;
+  Async& operator=(Async&&) = delete;
+  ~Async() noexcept {
+    if (coroutine_) {
+      coroutine_.destroy();
+    }
+  }
+
+  /**
+   * @brief Starts the coroutine. It runs until its first suspension on the
+   * calling thread.
+   *
+   * @param task the coroutine
+   * @param continuation receives the Token the coroutine co_returns
+   */
+  friend void fire(Async&& task, Continuation continuation) {
+    auto coroutine = std::exchange(task.coroutine_, nullptr);
+    coroutine.promise().continuation = std::move(continuation);
+    coroutine.resume();
+  }
+
+ private:
+  explicit Async(std::coroutine_handle<promise_type> coroutine) noexcept
+      : coroutine_(coroutine) {}
+  std::coroutine_handle<promise_type> coroutine_;  ///< The coroutine, if any
+};
+
+/**
+ * @brief Awaits a Callback from a coroutine. A suspendable Callback, such as a
+ * PetriNet, suspends the coroutine until its Continuation is called, which
+ * resumes the coroutine on that thread. Other Callbacks are fired right away.
+ *
+ * @tparam T the type of the callback.
+ * @param callback the Callback to fire; it has to outlive the co_await.
+ * @return an awaitable that results in the Token of the Callback
+ */
+template <typename T>
+auto await(const T& callback) {
+  struct Awaiter {
+    const T& callback;
+    Token result = Scheduled;
+
+    bool await_ready() {
+      if constexpr (is_suspendable<T>::value) {
+        return false;
+      } else {
+        result = fire(callback);
+        return true;
+      }
+    }
+    void await_suspend(std::coroutine_handle<> coroutine) {
+      // the Continuation may resume the coroutine before fire returns, so
+      // the awaiter is not used after fire.
+      fire(callback, [this, coroutine](Token token) {
+        result = token;
+        coroutine.resume();
+      });
+    }
+    Token await_resume() const noexcept { return result; }
+  };
+  return Awaiter{callback};
+}
+
+}  // namespace symmetri
+
+#endif
@@ -0,0 +1,90 @@
+#pragma once
+
+/** @file executor.h */
+
+#include <stddef.h>
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "symmetri/symmetri.h"
+#include "symmetri/types.h"
+
+namespace symmetri {
+
+/**
+ * @brief Executor runs the event loops of any amount of PetriNets on a fixed
+ * amount of loop threads. Unlike fire, submitting a PetriNet does not occupy
+ * the calling thread: the run is driven by a loop thread whenever it has
+ * events, and otherwise only waits in its own completion and reducer queues.
+ * Callbacks still run on the TaskSystem of the PetriNet.
+ *
+ * Every loop has a ready-list of the runs that have events. A run is placed on
+ * the loop with the fewest runs, and returns to the same loop whenever it has
+ * events, so its state stays in that loop's cache. Runs are rebalanced while
+ * they execute: a run that would queue behind others moves to an idle loop,
+ * and a loop that runs out of work steals from the ready-lists of the others.
+ *
+ * A PetriNet can be submitted again once its run finished. The PetriNet and
+ * the Executor have to outlive the runs that are submitted.
+ *
+ */
+class Executor {
+ public:
+  /**
+   * @brief Construct a new Executor.
+   *
+   * @param loop_count the amount of loop threads, at least 1
+   * @param name the loop threads are named `name`-<index>
+   */
+  explicit Executor(size_t loop_count = 1,
+                    const std::string &name = "executor");
+  ~Executor() noexcept;
+  Executor(Executor const &) = delete;
+  Executor(Executor &&) noexcept = delete;
+  Executor &operator=(Executor const &) = delete;
+  Executor &operator=(Executor &&) noexcept = delete;
+
+  /**
+   * @brief Starts a run of a PetriNet and returns right away.
+   *
+   * @param net
+   * @return std::future<Token> the result of the run, like fire. It is Failed
+   * right away if the PetriNet is already running.
+   */
+  std::future<Token> submit(const PetriNet &net);
+
+  /**
+   * @brief Starts a run of a PetriNet and returns right away.
+   *
+   * @param net
+   * @param continuation receives the result of the run on a loop thread, or
+   * Failed on the calling thread if the PetriNet is already running.
+   */
+  void submit(const PetriNet &net, Continuation continuation);
+
+  /**
+   * @brief Get the amount of unfinished runs on every loop.
+   *
+   * @return std::vector<size_t> indexed by loop
+   */
+  std::vector<size_t> getLoad() const;
+
+ private:
+  struct Loop;
+  struct Run;
+  void loop(size_t index);
+  void schedule(Run *run);
+  Run *take(size_t index);
+  std::unique_ptr<Loop[]> loops_;     ///< The ready-lists, by loop
+  const size_t loop_count_;           ///< The amount of loops
+  const std::string name_;            ///< The prefix of the thread names
+  std::atomic<bool> is_stopping_;     ///< Set when the Executor is destroyed
+  std::vector<std::thread> threads_;  ///< The loop threads
+};
+
+}  // namespace symmetri
@@ -0,0 +1,204 @@
+#pragma once
+
+/** @file histogram.h */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "symmetri/types.h"
+
+namespace symmetri {
+
+/**
+ * @brief Histogram counts values in log-linear buckets, like an HDR
+ * histogram. Values below 64 have a bucket of their own; above that every
+ * power of two is split in 32 buckets, so a bucket is at most ~3% wide
+ * relative to its values. Values from 2^40 on share the last bucket, while
+ * the exact minimum, maximum and sum are kept as well. Recording a value is a
+ * handful of instructions. The buckets are allocated in chunks of 32 when a
+ * value first falls in them, so a histogram of values that span a few orders
+ * of magnitude takes a few kilobytes.
+ *
+ */
+class Histogram {
+ public:
+  static constexpr size_t exact_values = 64;    ///< 2^6 values, one per bucket
+  static constexpr size_t sub_bucket_bits = 5;  ///< 2^5 buckets per octave
+  static constexpr size_t max_bits = 40;  ///< Values from 2^40 are saturated
+  static constexpr size_t bucket_count =
+      exact_values +
+      (max_bits - 6) * (size_t(1) << sub_bucket_bits);  ///< All buckets
+  static constexpr size_t chunk_bits = 5;  ///< 2^5 buckets per allocation
+  static_assert(bucket_count % (size_t(1) << chunk_bits) == 0);
+
+  /**
+   * @brief Adds a value.
+   *
+   * @param value
+   */
+  void record(uint64_t value) {
+    if (chunks_.empty()) {
+      chunks_.resize(bucket_count >> chunk_bits);
+    }
+    const auto b = bucketOf(value);
+    auto& chunk = chunks_[b >> chunk_bits];
+    if (chunk.empty()) {
+      chunk.resize(size_t(1) << chunk_bits, 0);
+    }
+    chunk[b & ((size_t(1) << chunk_bits) - 1)]++;
+    count_++;
+    sum_ += value;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+  }
+
+  /**
+   * @brief Adds all values of another histogram.
+   *
+   * @param other
+   */
+  void merge(const Histogram& other);
+
+  /**
+   * @brief Get the value below which `percentile` percent of the values are,
+   * with the resolution of the buckets. It never exceeds the maximum.
+   *
+   * @param percentile from 0 to 100
+   * @return uint64_t 0 if the histogram is empty
+   */
+  uint64_t percentile(double percentile) const noexcept;
+
+  /**
+   * @brief Get the amount of values that are at most `value`, with the
+   * resolution of the buckets: a bucket counts if all of its values are at
+   * most `value`.
+   *
+   * @param value
+   * @return uint64_t
+   */
+  uint64_t countAtMost(uint64_t value) const noexcept;
+
+  uint64_t count() const noexcept { return count_; }
+  uint64_t sum() const noexcept { return sum_; }
+  uint64_t min() const noexcept { return count_ == 0 ? 0 : min_; }
+  uint64_t max() const noexcept { return max_; }
+  double mean() const noexcept {
+    return count_ == 0 ? 0.0 : double(sum_) / double(count_);
+  }
+
+  /**
+   * @brief Get the count of a bucket.
+   *
+   * @param bucket less than bucket_count
+   * @return uint64_t
+   */
+  uint64_t bucket(size_t bucket) const noexcept {
+    if (chunks_.empty()) {
+      return 0;
+    }
+    const auto& chunk = chunks_[bucket >> chunk_bits];
+    return chunk.empty() ? 0
+                         : chunk[bucket & ((size_t(1) << chunk_bits) - 1)];
+  }
+
+  /**
+   * @brief Get the largest value that falls in a bucket.
+   *
+   * @param bucket less than bucket_count
+   * @return uint64_t
+   */
+  static uint64_t upperBound(size_t bucket) noexcept;
+
+  /**
+   * @brief Get the bucket of a value.
+   *
+   * @param value
+   * @return size_t
+   */
+  static size_t bucketOf(uint64_t value) noexcept {
+    if (value < exact_values) {
+      return static_cast<size_t>(value);
+    }
+    value = std::min<uint64_t>(value, (uint64_t(1) << max_bits) - 1);
+    // the highest bit selects the octave, the next 5 bits the bucket in it.
+    const size_t msb = 63 - static_cast<size_t>(__builtin_clzll(value));
+    const size_t shift = msb - sub_bucket_bits;
+    return exact_values + ((msb - 6) << sub_bucket_bits) +
+           static_cast<size_t>(value >> shift) -
+           (size_t(1) << sub_bucket_bits);
+  }
+
+ private:
+  std::vector<std::vector<uint64_t>>
+      chunks_;           ///< The bucket counts by chunk; both levels are empty
+                         ///< until a value falls in them
+  uint64_t count_ = 0;  ///< The amount of values
+  uint64_t sum_ = 0;    ///< The sum of the values
+  uint64_t min_ = std::numeric_limits<uint64_t>::max();  ///< The least value
+  uint64_t max_ = 0;  ///< The largest value
+};
+
+/**
+ * @brief TransitionLatencies holds the latencies of the asynchronous firings
+ * of a transition, in nanoseconds.
+ *
+ */
+struct TransitionLatencies {
+  Transition transition;  ///< The transition
+  Histogram queueing;     ///< From Scheduled until its Callback started
+  Histogram service;      ///< From the start until the end of its Callback
+  Histogram delivery;     ///< From the end of its Callback until the event
+                          ///< loop applied its result
+};
+
+/**
+ * @brief Latencies is a snapshot of the latency histograms of a PetriNet.
+ *
+ */
+struct Latencies {
+  std::string case_id;                          ///< The case_id of the net
+  std::vector<TransitionLatencies> transitions;  ///< Indexed like the net
+};
+
+/**
+ * @brief Writes the latencies as a JSON object. Every histogram has its
+ * count, sum, min, max, mean and some percentiles in nanoseconds, and its
+ * non-empty buckets as pairs of upper bound and count.
+ *
+ * @param latencies
+ * @return std::string
+ */
+std::string writeLatenciesJson(const Latencies& latencies);
+
+/**
+ * @brief Writes the latencies in the Prometheus text format, as the histograms
+ * `symmetri_transition_queueing_seconds`, `symmetri_transition_service_seconds`
+ * and `symmetri_transition_delivery_seconds` labelled by case_id and
+ * transition. The buckets are fixed from 1 us to 100 s, so series of different
+ * nets and scrapes line up.
+ *
+ * @param latencies
+ * @return std::string
+ */
+std::string writeLatenciesPrometheus(const Latencies& latencies);
+
+/**
+ * @brief Writes the latencies in the Prometheus text format to a file, for
+ * instance for the textfile collector of the node exporter. The file is
+ * written next to `path` first and then renamed, so a reader never sees half
+ * a file.
+ *
+ * @param latencies
+ * @param path
+ * @return true if the file is written
+ * @return false otherwise
+ */
+bool writeLatenciesPrometheusFile(const Latencies& latencies,
+                                  const std::string& path);
+
+}  // namespace symmetri
@@ -0,0 +1,122 @@
+#pragma once
+
+/** @file inplace_task.h */
+
+#include <stddef.h>
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace symmetri {
+
+/**
+ * @brief InplaceTask is a move-only wrapper around an invokable object without
+ * arguments, like std::function<void()>. The object is always stored inside
+ * the InplaceTask, so creating, moving and destroying one never allocates. An
+ * object that does not fit in `Capacity` bytes does not compile, instead of
+ * silently falling back to the heap.
+ *
+ * @tparam Capacity the amount of bytes available for the invokable object.
+ */
+template <size_t Capacity>
+class InplaceTask {
+ public:
+  InplaceTask() noexcept : vtable_(nullptr) {}
+
+  /**
+   * @brief Construct a new InplaceTask object that stores `f`.
+   *
+   * @tparam F the type of the invokable object.
+   * @param f the invokable object.
+   */
+  template <typename F, typename = std::enable_if_t<
+                            !std::is_same_v<std::decay_t<F>, InplaceTask>>>
+  InplaceTask(F&& f) : vtable_(&vtable<std::decay_t<F>>) {
+    using T = std::decay_t<F>;
+    static_assert(sizeof(T) <= Capacity,
+                  "The task does not fit in the inline storage; capture less "
+                  "or capture a pointer to the state instead.");
+    static_assert(alignof(T) <= alignof(max_align_t),
+                  "The task is over-aligned for the inline storage.");
+    static_assert(std::is_nothrow_move_constructible_v<T>,
+                  "Tasks are moved between queues and may not throw then.");
+    static_assert(std::is_invocable_v<T&>, "A task takes no arguments.");
+    ::new (static_cast<void*>(storage_)) T(std::forward<F>(f));
+  }
+
+  InplaceTask(InplaceTask&& other) noexcept : vtable_(other.vtable_) {
+    if (vtable_ != nullptr) {
+      vtable_->move(storage_, other.storage_);
+      other.vtable_ = nullptr;
+    }
+  }
+
+  InplaceTask& operator=(InplaceTask&& other) noexcept {
+    if (this != &other) {
+      reset();
+      if (other.vtable_ != nullptr) {
+        other.vtable_->move(storage_, other.storage_);
+        vtable_ = std::exchange(other.vtable_, nullptr);
+      }
+    }
+    return *this;
+  }
+
+  InplaceTask(const InplaceTask&) = delete;
+  InplaceTask& operator=(const InplaceTask&) = delete;
+
+  ~InplaceTask() noexcept { reset(); }
+
+  /**
+   * @brief Invokes the stored object. The InplaceTask may not be empty.
+   *
+   */
+  void operator()() { vtable_->invoke(storage_); }
+
+  /**
+   * @brief Checks if the InplaceTask stores an object.
+   *
+   * @return true if it stores an object
+   * @return false if it is empty
+   */
+  explicit operator bool() const noexcept { return vtable_ != nullptr; }
+
+ private:
+  struct VTable {
+    void (*invoke)(void*);
+    void (*move)(void*, void*) noexcept;  ///< Moves and destroys the source
+    void (*destroy)(void*) noexcept;
+  };
+
+  template <typename T>
+  static void invoke(void* self) {
+    (*static_cast<T*>(self))();
+  }
+
+  template <typename T>
+  static void move(void* self, void* other) noexcept {
+    ::new (self) T(std::move(*static_cast<T*>(other)));
+    static_cast<T*>(other)->~T();
+  }
+
+  template <typename T>
+  static void destroy(void* self) noexcept {
+    static_cast<T*>(self)->~T();
+  }
+
+  template <typename T>
+  inline static constexpr VTable vtable = {&invoke<T>, &move<T>, &destroy<T>};
+
+  void reset() noexcept {
+    if (vtable_ != nullptr) {
+      vtable_->destroy(storage_);
+      vtable_ = nullptr;
+    }
+  }
+
+  const VTable* vtable_;  ///< The operations on the stored object, if any
+  alignas(max_align_t) unsigned char storage_[Capacity];  ///< The object
+};
+
+}  // namespace symmetri
@@ -3,6 +3,7 @@
 /** @file parsers.h */
 
 #include <set>
+#include <string>
 #include <tuple>
 
 #include "symmetri/types.h"
@@ -37,4 +38,54 @@ std::tuple<Net, Marking, PriorityTable> readGrml(
  */
 std::tuple<Net, Marking> readPnml(const std::set<std::string> &files);
 
+/**
+ * @brief Like readGrml, but it also returns the bounds that are set with the
+ * `maxInFlight` attribute of transitions and the `capacity` attribute of
+ * places, read in the same pass. Nodes without the attribute are unbounded
+ * and left out.
+ *
+ * @param grml-files
+ * @return std::tuple<Net, Marking, PriorityTable, BoundTable, BoundTable> the
+ * net, its initial marking, its priorities, the max-in-flight limits of the
+ * transitions and the capacities of the places
+ */
+std::tuple<Net, Marking, PriorityTable, BoundTable, BoundTable>
+readGrmlWithBounds(const std::set<std::string> &files);
+
+/**
+ * @brief Like readPnml, but it also returns the bounds that are set with the
+ * `maxInFlight` element of transitions and the `capacity` element of places,
+ * which hold their value in a `text` element like the initial marking. They
+ * are read in the same pass. Nodes without the element are unbounded and left
+ * out.
+ *
+ * @param pnml-files
+ * @return std::tuple<Net, Marking, BoundTable, BoundTable> the net, its
+ * initial marking, the max-in-flight limits of the transitions and the
+ * capacities of the places
+ */
+std::tuple<Net, Marking, BoundTable, BoundTable> readPnmlWithBounds(
+    const std::set<std::string> &files);
+
+/**
+ * @brief Writes a net as a C++ header that defines a constexpr StaticNet
+ * named `name` in the namespace symmetri::nets. Places are sorted by name and
+ * transitions are ordered by name, so the output only depends on the net.
+ * Together with readPnmlWithBounds or readGrmlWithBounds this compiles a net
+ * into a header that can be constructed without parsing.
+ *
+ * @param net
+ * @param initial_marking
+ * @param priorities
+ * @param name a valid C++ identifier
+ * @param max_in_flight the max-in-flight limits of the transitions
+ * @param capacities the capacities of the places
+ * @return std::string the contents of the header
+ */
+std::string writeStaticNet(const Net &net, const Marking &initial_marking,
+                           const PriorityTable &priorities,
+                           const std::string &name,
+                           const BoundTable &max_in_flight = {},
+                           const BoundTable &capacities = {});
+
 }  // namespace symmetri
@@ -0,0 +1,236 @@
+#pragma once
+
+/** @file static_net.hpp */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <stdexcept>
+#include <string_view>
+
+namespace symmetri {
+
+/**
+ * @brief An arc of a StaticNet, referring to its transition and place by name.
+ * Its color is the name of a token color, e.g. "Success".
+ *
+ */
+struct StaticArc {
+  std::string_view transition;  ///< The transition the arc belongs to
+  std::string_view place;       ///< The place the arc connects to
+  std::string_view color;       ///< The name of the color of the arc
+  bool is_input;                ///< True if the arc goes from place to
+                                ///< transition
+};
+
+/**
+ * @brief Creates an arc from a place to a transition.
+ *
+ * @param transition
+ * @param place
+ * @param color
+ * @return constexpr StaticArc
+ */
+constexpr StaticArc input(std::string_view transition, std::string_view place,
+                          std::string_view color = "Success") {
+  return {transition, place, color, true};
+}
+
+/**
+ * @brief Creates an arc from a transition to a place.
+ *
+ * @param transition
+ * @param place
+ * @param color
+ * @return constexpr StaticArc
+ */
+constexpr StaticArc output(std::string_view transition,
+                           std::string_view place,
+                           std::string_view color = "Success") {
+  return {transition, place, color, false};
+}
+
+/**
+ * @brief A token of the initial marking of a StaticNet, referring to its place
+ * by name.
+ *
+ */
+struct StaticToken {
+  std::string_view place;             ///< The place the token is in
+  std::string_view color = "Success";  ///< The name of the color of the token
+};
+
+/**
+ * @brief A transition of a StaticNet, with an optional priority.
+ *
+ */
+struct StaticTransition {
+  constexpr StaticTransition(const char* _name, int8_t _priority = 0)
+      : name(_name), priority(_priority) {}
+  constexpr StaticTransition(std::string_view _name, int8_t _priority = 0)
+      : name(_name), priority(_priority) {}
+  std::string_view name;  ///< The name of the transition
+  int8_t priority;        ///< The priority of the transition
+};
+
+/**
+ * @brief An arc of a StaticNet with its transition and place resolved to
+ * indices.
+ *
+ */
+struct IndexedArc {
+  uint32_t transition;     ///< Index in StaticNet::transition
+  uint32_t place;          ///< Index in StaticNet::place
+  std::string_view color;  ///< The name of the color of the arc
+  bool is_input;           ///< True if the arc goes from place to transition
+};
+
+/**
+ * @brief A token of the initial marking of a StaticNet with its place resolved
+ * to an index.
+ *
+ */
+struct IndexedToken {
+  uint32_t place;          ///< Index in StaticNet::place
+  std::string_view color;  ///< The name of the color of the token
+};
+
+/**
+ * @brief A type-erased view on the tables of a StaticNet. This is what a
+ * PetriNet is constructed from.
+ *
+ */
+struct StaticNetView {
+  const std::string_view* place;       ///< The names of the places
+  size_t place_count;                  ///< The amount of places
+  const std::string_view* transition;  ///< The names of the transitions
+  const int8_t* priority;              ///< The priority of every transition
+  size_t transition_count;             ///< The amount of transitions
+  const IndexedArc* arc;               ///< All arcs of the net
+  size_t arc_count;                    ///< The amount of arcs
+  const IndexedToken* initial_marking;  ///< The tokens of the initial marking
+  size_t token_count;  ///< The amount of tokens in the initial marking
+  const uint32_t* max_in_flight;  ///< The limit of every transition, 0 if none
+  const uint32_t* capacity;       ///< The capacity of every place, 0 if none
+};
+
+/**
+ * @brief StaticNet is a Petri net description that is fixed at compile time.
+ * All names are resolved to indices while compiling, so constructing a
+ * PetriNet from it needs no parsing, string hashing or index lookups. Names
+ * that do not exist make the net fail to compile when it is declared
+ * constexpr. The max-in-flight limits and capacities are applied as with
+ * PetriNet::setMaxInFlight and PetriNet::setCapacity, where 0 is unbounded;
+ * makeStaticNet leaves them all unbounded.
+ *
+ * @tparam P the amount of places
+ * @tparam T the amount of transitions
+ * @tparam A the amount of arcs
+ * @tparam M the amount of tokens in the initial marking
+ */
+template <size_t P, size_t T, size_t A, size_t M>
+struct StaticNet {
+  std::array<std::string_view, P> place;       ///< The names of the places
+  std::array<std::string_view, T> transition;  ///< The names of transitions
+  std::array<int8_t, T> priority;              ///< Indexed like transition
+  std::array<IndexedArc, A> arc;               ///< All arcs of the net
+  std::array<IndexedToken, M> initial_marking;  ///< The initial marking
+  std::array<uint32_t, T> max_in_flight;       ///< Indexed like transition
+  std::array<uint32_t, P> capacity;            ///< Indexed like place
+
+  /**
+   * @brief Get a type-erased view on the tables.
+   *
+   * @return StaticNetView
+   */
+  constexpr StaticNetView view() const {
+    return {place.data(),         P,
+            transition.data(),    priority.data(),
+            T,                    arc.data(),
+            A,                    initial_marking.data(),
+            M,                    max_in_flight.data(),
+            capacity.data()};
+  }
+};
+
+}  // namespace symmetri
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace sym_impl {
+template <typename Names>
+constexpr uint32_t indexOf(const Names& names, std::string_view name) {
+  for (size_t i = 0; i < names.size(); i++) {
+    if (names[i] == name) {
+      return static_cast<uint32_t>(i);
+    }
+  }
+  throw std::invalid_argument("unknown place or transition name");
+}
+
+template <size_t P, size_t T, size_t A, size_t M>
+constexpr symmetri::StaticNet<P, T, A, M> resolve(
+    const std::string_view (&places)[P],
+    const symmetri::StaticTransition (&transitions)[T],
+    const symmetri::StaticArc (&arcs)[A]) {
+  symmetri::StaticNet<P, T, A, M> net{};
+  for (size_t i = 0; i < P; i++) {
+    net.place[i] = places[i];
+  }
+  for (size_t i = 0; i < T; i++) {
+    net.transition[i] = transitions[i].name;
+    net.priority[i] = transitions[i].priority;
+  }
+  for (size_t i = 0; i < A; i++) {
+    net.arc[i] = {indexOf(net.transition, arcs[i].transition),
+                  indexOf(net.place, arcs[i].place), arcs[i].color,
+                  arcs[i].is_input};
+  }
+  return net;
+}
+}  // namespace sym_impl
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+namespace symmetri {
+
+/**
+ * @brief Creates a StaticNet from places, transitions, arcs and an initial
+ * marking. Evaluated in a constexpr context, an arc or token referring to a
+ * name that does not exist is a compile error. For example:
+ *
+ * @code
+ * constexpr auto net = symmetri::makeStaticNet(
+ *     {"Pa", "Pb"}, {"t0"},
+ *     {symmetri::input("t0", "Pa"), symmetri::output("t0", "Pb")},
+ *     {{"Pa"}});
+ * @endcode
+ *
+ * @return StaticNet<P, T, A, M>
+ */
+template <size_t P, size_t T, size_t A, size_t M>
+constexpr StaticNet<P, T, A, M> makeStaticNet(
+    const std::string_view (&places)[P],
+    const StaticTransition (&transitions)[T], const StaticArc (&arcs)[A],
+    const StaticToken (&initial_marking)[M]) {
+  auto net = sym_impl::resolve<P, T, A, M>(places, transitions, arcs);
+  for (size_t i = 0; i < M; i++) {
+    net.initial_marking[i] = {
+        sym_impl::indexOf(net.place, initial_marking[i].place),
+        initial_marking[i].color};
+  }
+  return net;
+}
+
+/**
+ * @brief Creates a StaticNet without an initial marking.
+ *
+ * @return StaticNet<P, T, A, 0>
+ */
+template <size_t P, size_t T, size_t A>
+constexpr StaticNet<P, T, A, 0> makeStaticNet(
+    const std::string_view (&places)[P],
+    const StaticTransition (&transitions)[T], const StaticArc (&arcs)[A]) {
+  return sym_impl::resolve<P, T, A, 0>(places, transitions, arcs);
+}
+
+}  // namespace symmetri
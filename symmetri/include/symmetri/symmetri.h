@@ -10,6 +10,9 @@
 #include <vector>
 
 #include "symmetri/callback.h"
+#include "symmetri/coroutine.h"
+#include "symmetri/histogram.h"
+#include "symmetri/static_net.hpp"
 #include "symmetri/tasks.h"
 #include "symmetri/types.h"
 
@@ -22,8 +25,69 @@ namespace symmetri {
  *
  */
 struct Petri;
+struct CompiledNet;
 class Token;
 
+/**
+ * @brief NetTemplate holds the compiled, immutable structure of a Petri net:
+ * its places, transitions, arcs, priorities, initial marking and bounds. It is
+ * compiled once and can then be used to create any amount of PetriNet
+ * instances. The instances share the structure and only allocate their own
+ * marking, Callbacks and event log, so creating one is cheap. A NetTemplate is
+ * cheap to copy and may be destroyed before the instances created from it.
+ *
+ */
+class NetTemplate final {
+ public:
+  /**
+   * @brief Compiles a net and its initial marking.
+   *
+   * @param net
+   * @param initial_marking
+   * @param priorities
+   */
+  NetTemplate(const Net &net, const Marking &initial_marking,
+              const PriorityTable &priorities = {});
+
+  /**
+   * @brief Compiles a net from a set of paths to PNML- or GRML-files. Since
+   * PNML-files do not have priorities; you can optionally add a priority table
+   * manually. The max-in-flight limits and capacities in the files are kept
+   * and set on every PetriNet created from the template, as with
+   * setMaxInFlight and setCapacity.
+   *
+   * @param petri_net_xmls
+   * @param priorities
+   */
+  explicit NetTemplate(const std::set<std::string> &petri_net_xmls,
+                       const PriorityTable &priorities = {});
+
+  /**
+   * @brief Compiles a StaticNet.
+   *
+   * @tparam P the amount of places
+   * @tparam T the amount of transitions
+   * @tparam A the amount of arcs
+   * @tparam M the amount of tokens in the initial marking
+   * @param net
+   */
+  template <size_t P, size_t T, size_t A, size_t M>
+  explicit NetTemplate(const StaticNet<P, T, A, M> &net)
+      : NetTemplate(net.view()) {}
+
+  /**
+   * @brief Compiles the tables of a StaticNet. The tables only need to outlive
+   * the constructor.
+   *
+   * @param net
+   */
+  explicit NetTemplate(const StaticNetView &net);
+
+ private:
+  friend class PetriNet;
+  std::shared_ptr<const CompiledNet> impl;  ///< The shared compiled net
+};
+
 /**
  * @brief PetriNet exposes the possible constructors to create PetriNets. It
  * also allows the user to register a Callback to a transition, or to get a
@@ -35,7 +99,8 @@ class PetriNet final {
   /**
    * @brief Construct a new PetriNet object from a set of paths to PNML- or
    * GRML-files. Since PNML-files do not have priorities; you can optionally add
-   * a priority table manually.
+   * a priority table manually. The max-in-flight limits and capacities in the
+   * files are set as with setMaxInFlight and setCapacity.
    *
    * @param petri_net_xmls
    * @param case_id
@@ -63,11 +128,59 @@ class PetriNet final {
            const Marking &initial_marking, const Marking &goal_marking = {},
            const PriorityTable &priorities = {});
 
+  /**
+   * @brief Construct a new PetriNet object from a StaticNet. The net, its
+   * initial marking and its priorities are fixed at compile time, so
+   * constructing it does not involve parsing or looking up names.
+   *
+   * @tparam P the amount of places
+   * @tparam T the amount of transitions
+   * @tparam A the amount of arcs
+   * @tparam M the amount of tokens in the initial marking
+   * @param net
+   * @param case_id
+   * @param threadpool
+   * @param goal_marking
+   */
+  template <size_t P, size_t T, size_t A, size_t M>
+  PetriNet(const StaticNet<P, T, A, M> &net, const std::string &case_id,
+           std::shared_ptr<TaskSystem> threadpool,
+           const Marking &goal_marking = {})
+      : PetriNet(net.view(), case_id, threadpool, goal_marking) {}
+
+  /**
+   * @brief Construct a new PetriNet object from a view on the tables of a
+   * StaticNet. The tables only need to outlive the constructor.
+   *
+   * @param net
+   * @param case_id
+   * @param threadpool
+   * @param goal_marking
+   */
+  PetriNet(const StaticNetView &net, const std::string &case_id,
+           std::shared_ptr<TaskSystem> threadpool,
+           const Marking &goal_marking = {});
+
+  /**
+   * @brief Construct a new PetriNet object from a NetTemplate. The structure of
+   * the net is shared with the template, so only the mutable state of the
+   * PetriNet is allocated.
+   *
+   * @param net
+   * @param case_id
+   * @param threadpool
+   * @param goal_marking
+   */
+  PetriNet(const NetTemplate &net, const std::string &case_id,
+           std::shared_ptr<TaskSystem> threadpool,
+           const Marking &goal_marking = {});
+
   /**
    * @brief By registering a input transition you get a handle to manually force
    * a transition to fire. It returns a callable handle that will schedule a
    * reducer for the transition, generating tokens. This only works for
-   * transitions that have no input places.
+   * transitions that have no input places. Like any other firing it respects
+   * setMaxInFlight and setCapacity: without room it waits until there is.
    *
    * @param transition the name of transition
    * @return std::function<void()>
@@ -120,6 +233,108 @@ class PetriNet final {
    */
   std::vector<Transition> getActiveTransitions() const noexcept;
 
+  /**
+   * @brief Set the maximum amount of completions and reducers the event loop
+   * applies before it determines the enabled transitions again. A smaller batch
+   * bounds the latency between a completion and the transitions it enables, a
+   * larger batch amortizes the passes over more completions. It can only be
+   * changed while the PetriNet is not running. The default is 1024.
+   *
+   * @param max_batch_size the maximum batch size, at least 1
+   */
+  void setMaxBatchSize(size_t max_batch_size) const noexcept;
+
+  /**
+   * @brief Set how the event loop waits for completions and reducers. By
+   * default it blocks right away; a policy that spins or yields first lowers
+   * the latency between a completion and the next dispatch, at the cost of
+   * keeping the thread that fires the PetriNet busy. Use it together with a
+   * TaskSystem with a similar WaitPolicy. It can only be changed while the
+   * PetriNet is not running.
+   *
+   * @param wait_policy
+   */
+  void setWaitPolicy(WaitPolicy wait_policy) const noexcept;
+
+  /**
+   * @brief Set the firing delay of a transition: once it fires, it consumes
+   * its input tokens right away, but its Callback only runs after the delay.
+   * Meanwhile it is active, yet occupies no thread; the delay waits in the
+   * timer wheel of the TaskSystem. A transition that consumes and produces a
+   * token in the same place, with a delay, fires at that interval. Cancelling
+   * the PetriNet ends pending delays right away, as Canceled. It can only be
+   * changed while the PetriNet is not running.
+   *
+   * @param transition
+   * @param delay zero, the default, fires the transition without delay
+   */
+  void setDelay(const std::string &transition,
+                Clock::duration delay) const noexcept;
+
+  /**
+   * @brief Set the deadline of the asynchronous Callback of a transition,
+   * counted from the moment it is scheduled. If it does not complete in time,
+   * the transition ends right away: it produces TimedOut tokens in its output
+   * places and logs TimedOut, so a Callback that is stuck does not hold up the
+   * rest of the net. The Callback is cancelled, unless other firings of the
+   * transition run as well, as those share the Callback. A Callback that did
+   * not start yet is not fired at all; one that runs has its result dropped
+   * whenever it still completes. It keeps its own state alive until then, so
+   * the PetriNet may be destroyed in the meantime. Synchronous Callbacks run on
+   * the event loop and have no deadline. It can only be changed while the
+   * PetriNet is not running.
+   *
+   * @param transition
+   * @param timeout zero, the default, sets no deadline
+   */
+  void setTimeout(const std::string &transition,
+                  Clock::duration timeout) const noexcept;
+
+  /**
+   * @brief Set the most Callbacks of a transition that may be active at once.
+   * A transition at its limit does not fire again until one of its Callbacks
+   * completes, so a place with many tokens does not flood the TaskSystem with
+   * tasks. Delays count as active. It can only be changed while the PetriNet
+   * is not running.
+   *
+   * @param transition
+   * @param limit zero, the default, sets no limit
+   */
+  void setMaxInFlight(const std::string &transition,
+                      uint32_t limit) const noexcept;
+
+  /**
+   * @brief Set the most tokens a place may hold. A transition does not fire
+   * if its output tokens would not fit, where the output tokens of active
+   * transitions count as if they are already there. It fires once consumers
+   * make room, so a full place holds back its producers. It can only be
+   * changed while the PetriNet is not running.
+   *
+   * @param place
+   * @param capacity zero, the default, sets no capacity
+   */
+  void setCapacity(const std::string &place, uint32_t capacity) const noexcept;
+
+  /**
+   * @brief Get the statistics of the batch sizes of all runs of this PetriNet.
+   * This function is thread-safe and be called during PetriNet execution.
+   *
+   * @return BatchStatistics
+   */
+  BatchStatistics getBatchStatistics() const noexcept;
+
+  /**
+   * @brief Get a snapshot of the latency histograms of all runs of this
+   * PetriNet. Every firing that is dispatched to the TaskSystem records how
+   * long it was queued, how long its Callback ran and how long its result took
+   * to be applied. Synchronous firings, also after a delay, and delays that
+   * are cancelled record nothing. This function is thread-safe and can be
+   * called during PetriNet execution.
+   *
+   * @return Latencies
+   */
+  Latencies getLatencies() const noexcept;
+
   /**
    * @brief reuseApplication resets the PetriNet such that the same net can
    * be used again after a cancel call or natural termination of the PetriNet.
@@ -132,10 +347,12 @@ class PetriNet final {
   bool reuseApplication(const std::string &case_id);
 
   friend Token(symmetri::fire)(const PetriNet &);
+  friend void(symmetri::fire)(const PetriNet &, Continuation);
   friend void(symmetri::cancel)(const PetriNet &);
   friend void(symmetri::pause)(const PetriNet &);
   friend void(symmetri::resume)(const PetriNet &);
   friend Eventlog(symmetri::getLog)(const PetriNet &);
+  friend class Executor;
 
  private:
   /**
@@ -3,43 +3,138 @@
 /** @file tasks.h */
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <atomic>
-#include <functional>
+#include <chrono>
 #include <memory>
+#include <string>
 #include <thread>
 #include <vector>
 
+#include "symmetri/inplace_task.h"
+
 namespace symmetri {
 
+/**
+ * @brief WaitPolicy determines how a thread waits for work. It first polls
+ * `spins` times in a busy loop, then polls `yields` times while yielding its
+ * time slice, and then parks in the kernel until it is woken up. The default
+ * parks right away, which uses no CPU while idle but adds the wake-up latency
+ * of the kernel to every hand-over. Spinning and yielding cut that latency at
+ * the cost of keeping a core busy while waiting.
+ *
+ */
+struct WaitPolicy {
+  size_t spins = 0;   ///< The amount of polls in a busy loop
+  size_t yields = 0;  ///< The amount of polls with a yield in between
+};
+
+/**
+ * @brief Scheduling determines how the tasks of a TaskSystem are distributed
+ * over its workers.
+ *
+ */
+enum class Scheduling {
+  SharedQueue,   ///< All workers take tasks from one shared lock-free queue
+  WorkStealing,  ///< Every worker has its own deque and steals when it is empty
+  Priority       ///< Workers take the task with the highest aged priority
+};
+
+/**
+ * @brief TaskSystemConfig configures the threads of a TaskSystem. CPU sets and
+ * names are applied on Linux and ignored elsewhere. Placement is best-effort:
+ * CPUs that do not exist or are not allowed for the process are skipped, and a
+ * worker that can not be pinned at all runs unpinned.
+ *
+ * A worker pins itself before it takes its first task, so memory it allocates
+ * afterwards, such as its work-stealing deque, is first touched on its own
+ * NUMA node.
+ *
+ */
+struct TaskSystemConfig {
+  size_t thread_count =
+      std::thread::hardware_concurrency();  ///< The amount of workers
+  WaitPolicy wait_policy = {};              ///< How idle workers wait
+  Scheduling scheduling =
+      Scheduling::SharedQueue;  ///< How tasks are distributed over workers
+  std::chrono::steady_clock::duration priority_aging =
+      std::chrono::milliseconds(1);  ///< With Scheduling::Priority, a queued
+                                     ///< task gains a priority level per
+                                     ///< priority_aging it waits
+  std::string name =
+      "symmetri";  ///< Workers are named `name`-<index>
+  std::vector<std::vector<size_t>>
+      worker_cpus;  ///< Worker i runs on worker_cpus[i % size], if not empty
+  std::vector<size_t>
+      numa_nodes;  ///< Otherwise worker i runs on the CPUs of NUMA node
+                   ///< numa_nodes[i % size], if not empty
+  std::vector<size_t>
+      loop_cpus;  ///< A thread that calls fire on a PetriNet that uses this
+                  ///< TaskSystem runs on these CPUs until fire returns. Workers
+                  ///< without worker_cpus do not use them.
+  std::chrono::steady_clock::duration timer_resolution =
+      std::chrono::microseconds(100);  ///< The tick of the timer wheel; a
+                                       ///< delayed task is pushed at most a
+                                       ///< tick after its delay expired
+};
+
 /**
  * @brief forward declaration of the internal TaskQueue
  *
  */
 class TaskQueue;
 
+/**
+ * @brief forward declaration of the internal TimerThread
+ *
+ */
+class TimerThread;
+
 /**
  * @brief Create a TaskSystem object. The only way to create a TaskSystem
  * is through this factory. We enforce the use of a smart pointer to make sure
  * the pool stays alive until both the original scope of the pool and net is
  * exited.
  *
- * @param thread_count the amount of threads in the pool. The simplest way to
- * avoid deadlocks in the net is to make sure thread_count is at least the
- * maximum amount of transitions in the net. are ran in parallel.
+ * @param thread_count the amount of threads in the pool. Callbacks that block
+ * occupy a thread while they run, so to avoid deadlocks thread_count should be
+ * at least the amount of blocking Callbacks that wait on each other.
+ * Suspendable Callbacks, such as nested nets, do not occupy a thread while
+ * they wait.
  * @return std::shared_ptr<const TaskSystem>
  */
 class TaskSystem {
  public:
-  using Task = std::function<void()>;
+  static constexpr size_t task_capacity =
+      64;  ///< The amount of bytes a Task can store inline
+  using Task = InplaceTask<task_capacity>;  ///< Tasks never allocate
+  using TimerId = uint64_t;                 ///< Identifies a delayed task
 
   /**
    * @brief Construct a new Task System object with n threads
    *
    * @param n_threads if less then 1, it defaults to
    * std::thread::hardware_concurrency()
+   * @param wait_policy how idle workers wait for new tasks
+   * @param scheduling how tasks are distributed over the workers. With
+   * work-stealing, a task that is pushed by a worker, e.g. by a nested
+   * PetriNet, goes to the deque of that worker and runs last-in first-out;
+   * other tasks go to a shared injection queue. Idle workers steal the oldest
+   * tasks from the deques of randomly chosen workers. With priority
+   * scheduling, workers take the queued task with the highest priority, where
+   * waiting raises the priority as set by TaskSystemConfig::priority_aging.
    */
-  explicit TaskSystem(size_t n_threads = std::thread::hardware_concurrency());
+  explicit TaskSystem(size_t n_threads = std::thread::hardware_concurrency(),
+                      WaitPolicy wait_policy = {},
+                      Scheduling scheduling = Scheduling::SharedQueue);
+
+  /**
+   * @brief Construct a new Task System object from a configuration.
+   *
+   * @param config
+   */
+  explicit TaskSystem(const TaskSystemConfig& config);
   ~TaskSystem() noexcept;
   TaskSystem(TaskSystem const&) = delete;
   TaskSystem(TaskSystem&&) noexcept = delete;
@@ -47,17 +142,71 @@ class TaskSystem {
   TaskSystem& operator=(TaskSystem&&) noexcept = delete;
 
   /**
-   * @brief push tasks the queue for later execution on the thread pool.
+   * @brief push tasks the queue for later execution on the thread pool. A
+   * Task stores its invokable inline, so an invokable that is larger than
+   * task_capacity does not compile.
    *
    * @param p
+   * @param priority with Scheduling::Priority, tasks with a higher priority
+   * run first; tasks of the same priority run in the order they were pushed.
+   * Other schedulers ignore it.
+   */
+  void push(Task&& p, int8_t priority = 0) const;
+
+  /**
+   * @brief push a task to the queue once a delay has passed. Pending tasks are
+   * kept in a hierarchical timer wheel that is advanced by a single timer
+   * thread, so they occupy no worker and adding or cancelling one is O(1). The
+   * timer thread starts with the first delayed task. Delayed tasks that are
+   * still pending when the TaskSystem is destroyed are dropped.
+   *
+   * @param delay the task is pushed no earlier than `delay` from now, and at
+   * most TaskSystemConfig::timer_resolution later
+   * @param p
+   * @return TimerId cancels the task with cancelTimer
+   */
+  TimerId pushAfter(std::chrono::steady_clock::duration delay, Task&& p) const;
+
+  /**
+   * @brief Runs a task on the timer thread once a delay has passed, instead of
+   * pushing it to the queue. It still runs when all workers are busy, so it
+   * suits tasks that hand work over, like posting to a queue; it has to be
+   * brief and must not block, as it holds up all other delayed tasks.
+   *
+   * @param delay as in pushAfter
+   * @param p
+   * @return TimerId cancels the task with cancelTimer
+   */
+  TimerId callAfter(std::chrono::steady_clock::duration delay, Task&& p) const;
+
+  /**
+   * @brief Drops a task of pushAfter or callAfter, if its delay did not
+   * expire yet.
+   *
+   * @param id
+   * @return true if the task is dropped
+   * @return false if the task is already pushed or dropped
+   */
+  bool cancelTimer(TimerId id) const;
+
+  /**
+   * @brief Get the CPUs reserved for threads that run the event loop of a
+   * PetriNet.
+   *
+   * @return const std::vector<size_t>& empty if they are not restricted
    */
-  void push(Task&& p) const;
+  const std::vector<size_t>& getLoopCpus() const noexcept;
 
  private:
-  void loop();
+  void loop(size_t worker);
   std::vector<std::thread> pool_;
   std::atomic<bool> is_running_;
   std::unique_ptr<TaskQueue> queue_;
+  std::unique_ptr<TimerThread> timers_;  ///< Pushes delayed tasks
+  const WaitPolicy wait_policy_;
+  const std::string name_;  ///< The prefix of the names of the workers
+  const std::vector<std::vector<size_t>> worker_cpus_;  ///< CPUs, by worker
+  const std::vector<size_t> loop_cpus_;  ///< The CPUs of event loops
 };
 
 }  // namespace symmetri
@@ -2,9 +2,12 @@
 
 /** @file types.h */
 
+#include <stddef.h>
 #include <stdint.h>
 
+#include <array>
 #include <chrono>
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -31,11 +34,28 @@ struct Event {
   std::string transition;   ///< The transition that generated the event
   Token state;              ///< The result of the event
   Clock::time_point stamp;  ///< The timestamp of the event
+  uint64_t instance = 0;    ///< The firing of the transition that generated
+                            ///< the event. Concurrent firings of a transition
+                            ///< have their own; synchronous ones have 0
 };
 
 using Eventlog = std::vector<Event>;  ///< The eventlog is simply a log of
                                       ///< events, sorted by their stamp
 
+/**
+ * @brief BatchStatistics describes how many completions and reducers the event
+ * loop of a PetriNet applies at once, i.e. between two passes that determine
+ * the enabled transitions. Bucket i of the histogram counts the batches of
+ * 2^i up to 2^(i+1) - 1 events.
+ *
+ */
+struct BatchStatistics {
+  uint64_t batches = 0;  ///< The amount of batches
+  uint64_t events = 0;   ///< The amount of events in all batches
+  size_t largest = 0;    ///< The size of the largest batch
+  std::array<uint64_t, 32> histogram = {};  ///< Batches by size
+};
+
 using Net = std::unordered_map<
     Transition,
     std::pair<std::vector<std::pair<Place, Token>>,
@@ -56,6 +76,10 @@ using PriorityTable =
     std::vector<std::pair<Transition, int8_t>>;  ///< Priority is limited from
                                                  ///< -128 to 127
 
+using BoundTable =
+    std::vector<std::pair<std::string, uint32_t>>;  ///< A bound per place or
+                                                    ///< transition, by name
+
 /**
  * @brief A DirectMutation is a synchronous no-operation function. It simply
  * mutates the mutation on the petri net executor loop. This way the deferring
@@ -65,6 +89,13 @@ using PriorityTable =
 struct DirectMutation {};
 class PetriNet;
 
+/**
+ * @brief Continuation receives the result of a suspendable Callback once it
+ * is done. It may be called from any thread, but only once.
+ *
+ */
+using Continuation = std::function<void(Token)>;
+
 /**
  * @brief A DirectMutation is a synchronous Callback that always
  * completes.
@@ -88,6 +119,31 @@ Token fire(const DirectMutation &);
  */
 Token fire(const PetriNet &);
 
+/**
+ * @brief Fires a PetriNet without blocking the calling thread. The event loop
+ * runs on the threadpool of the net whenever there are events to process, and
+ * does not occupy a thread while it waits. This makes a PetriNet a suspendable
+ * Callback: a nested net does not hold on to a thread of its parent's
+ * TaskSystem while it runs, so nets can be nested deeper than the TaskSystem
+ * has threads. A net that is fired as the Callback of a parent is driven by
+ * the loop of the parent instead of by the threadpool. The PetriNet has to
+ * outlive the run.
+ *
+ * @param continuation receives the result once the net is done, on the thread
+ * that processed the last event. If the net is already running, it receives
+ * Failed right away.
+ */
+void fire(const PetriNet &, Continuation continuation);
+
+/**
+ * @brief A PetriNet is a nested net: as the Callback of a parent it runs as a
+ * sub-state of the event loop of the parent, so it costs no extra thread and
+ * its events do not hop between threads.
+ *
+ * @return true
+ */
+bool isNested(const PetriNet &);
+
 /**
  * @brief The cancel specialization for a PetriNet breaks the PetriNets'
  * internal loop. It will not queue any new Callbacks and it will cancel all
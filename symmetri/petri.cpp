@@ -3,6 +3,10 @@
 #include <array>
 #include <initializer_list>
 #include <iterator>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "polling.h"
 
 namespace symmetri {
 std::tuple<std::vector<std::string>, std::vector<std::string>,
@@ -10,179 +14,773 @@ std::tuple<std::vector<std::string>, std::vector<std::string>,
 convert(const Net& _net) {
   const auto transition_count = _net.size();
   std::vector<std::string> transitions;
-  std::vector<std::string> places;
+  std::unordered_set<std::string_view> unique_places;
   std::vector<Callback> store;
   transitions.reserve(transition_count);
   store.reserve(transition_count);
+  unique_places.reserve(transition_count);
   for (const auto& [t, io] : _net) {
     transitions.push_back(t);
     store.emplace_back(identity<DirectMutation>{});
     for (const auto& p : io.first) {
-      places.push_back(p.first);
+      unique_places.insert(p.first);
     }
     for (const auto& p : io.second) {
-      places.push_back(p.first);
+      unique_places.insert(p.first);
     }
-    // sort and remove duplicates.
-    std::sort(places.begin(), places.end());
-    auto last = std::unique(places.begin(), places.end());
-    places.erase(last, places.end());
   }
+  // places are referred to by many arcs; only sort the distinct names.
+  std::vector<std::string_view> sorted_places(unique_places.begin(),
+                                              unique_places.end());
+  std::sort(sorted_places.begin(), sorted_places.end());
+  std::vector<std::string> places(sorted_places.begin(), sorted_places.end());
   return {std::move(transitions), std::move(places), std::move(store)};
 }
 
 std::tuple<std::vector<SmallVectorInput>, std::vector<SmallVectorInput>>
 populateIoLookups(const Net& _net, const std::vector<Place>& ordered_places) {
+  const auto place_index = createIndexLookup(ordered_places);
   std::vector<SmallVectorInput> input_n, output_n;
+  input_n.reserve(_net.size());
+  output_n.reserve(_net.size());
   for (const auto& [t, io] : _net) {
     SmallVectorInput q_in, q_out;
     for (const auto& p : io.first) {
-      q_in.push_back(
-          std::make_tuple(toIndex(ordered_places, p.first), p.second));
+      q_in.push_back({place_index.at(p.first), p.second});
     }
-    input_n.push_back(q_in);
+    input_n.push_back(std::move(q_in));
     for (const auto& p : io.second) {
-      q_out.push_back({toIndex(ordered_places, p.first), p.second});
+      q_out.push_back({place_index.at(p.first), p.second});
     }
-    output_n.push_back(q_out);
+    output_n.push_back(std::move(q_out));
   }
-  return {input_n, output_n};
+  return {std::move(input_n), std::move(output_n)};
 }
 
 std::vector<SmallVector> createReversePlaceToTransitionLookup(
     size_t place_count, size_t transition_count,
     const std::vector<SmallVectorInput>& input_transitions) {
-  std::vector<SmallVector> p_to_ts_n;
-  for (size_t p = 0; p < place_count; p++) {
-    SmallVector q;
-    for (size_t c = 0; c < transition_count; c++) {
-      for (const auto& [input_place, input_color] : input_transitions[c]) {
-        if (p == input_place && std::find(q.begin(), q.end(), c) == q.end()) {
-          q.push_back(c);
-        }
+  std::vector<SmallVector> p_to_ts_n(place_count);
+  for (size_t t = 0; t < transition_count; t++) {
+    for (const auto& [input_place, input_color] : input_transitions[t]) {
+      // transitions are visited in ascending order, so a transition with
+      // multiple arcs from the same place can only be the last one added.
+      auto& q = p_to_ts_n[input_place];
+      if (q.empty() || q.back() != t) {
+        q.push_back(t);
       }
     }
-    p_to_ts_n.push_back(q);
   }
   return p_to_ts_n;
 }
 
+ArcTable createArcTable(const std::vector<SmallVectorInput>& io_n) {
+  return ArcTable::fromRows(io_n, [](const AugmentedToken& token) {
+    return Arc{static_cast<uint32_t>(std::get<size_t>(token)),
+               std::get<Token>(token)};
+  });
+}
+
+CsrTable<uint32_t> createReversePlaceToTransitionLookup(
+    size_t place_count, const ArcTable& input_n) {
+  std::vector<std::pair<uint32_t, uint32_t>> entries;
+  entries.reserve(input_n.elementCount());
+  for (size_t t = 0; t < input_n.size(); t++) {
+    const auto inputs = input_n[t];
+    for (size_t i = 0; i < inputs.size(); i++) {
+      // the inputs are sorted, so arcs from the same place are adjacent.
+      if (i == 0 || inputs[i].place != inputs[i - 1].place) {
+        entries.push_back({inputs[i].place, static_cast<uint32_t>(t)});
+      }
+    }
+  }
+  return CsrTable<uint32_t>(place_count, entries);
+}
+
 std::vector<int8_t> createPriorityLookup(
     const std::vector<Transition> transition, const PriorityTable& _priority) {
+  // emplace keeps the first entry of a transition that is listed twice.
+  std::unordered_map<std::string_view, int8_t> lookup;
+  lookup.reserve(_priority.size());
+  for (const auto& [t, p] : _priority) {
+    lookup.emplace(t, p);
+  }
   std::vector<int8_t> priority;
+  priority.reserve(transition.size());
   for (const auto& t : transition) {
-    auto ptr = std::find_if(_priority.begin(), _priority.end(),
-                            [t](const auto& a) { return a.first == t; });
-    priority.push_back(ptr != _priority.end() ? ptr->second : 0);
+    const auto it = lookup.find(t);
+    priority.push_back(it != lookup.end() ? it->second : 0);
   }
   return priority;
 }
 
+CompiledNet::CompiledNet(const Net& _net, const PriorityTable& _priority,
+                         const Marking& _initial_tokens,
+                         const BoundTable& _max_in_flight,
+                         const BoundTable& _capacities) {
+  std::vector<Callback> store;
+  std::tie(transition, place, store) = convert(_net);
+  const auto [inputs, outputs] = populateIoLookups(_net, place);
+  input_n = createArcTable(inputs);
+  output_n = createArcTable(outputs);
+  priority = createPriorityLookup(transition, _priority);
+  compile();
+  initial_tokens = toTokens(_initial_tokens);
+  // like setMaxInFlight and setCapacity, bounds of unknown names are ignored.
+  max_in_flight.assign(transition.size(), 0);
+  for (const auto& [t, limit] : _max_in_flight) {
+    const auto it = transition_index.find(t);
+    if (it != transition_index.end()) {
+      max_in_flight[it->second] = limit;
+    }
+  }
+  capacity.assign(place.size(), 0);
+  for (const auto& [p, bound] : _capacities) {
+    const auto it = place_index.find(p);
+    if (it != place_index.end()) {
+      capacity[it->second] = bound;
+    }
+  }
+}
+
+CompiledNet::CompiledNet(const StaticNetView& _net) {
+  // nets rarely have more than a handful of colors, so a linear cache avoids
+  // looking up the same name for every arc.
+  std::vector<std::pair<std::string_view, Token>> colors;
+  const auto color = [&colors](std::string_view name) {
+    for (const auto& [n, c] : colors) {
+      if (n == name) {
+        return c;
+      }
+    }
+    colors.push_back({name, Token(std::string(name).c_str())});
+    return colors.back().second;
+  };
+
+  place.assign(_net.place, _net.place + _net.place_count);
+  transition.assign(_net.transition, _net.transition + _net.transition_count);
+  priority.assign(_net.priority, _net.priority + _net.transition_count);
+  std::vector<std::pair<uint32_t, Arc>> inputs, outputs;
+  for (size_t i = 0; i < _net.arc_count; i++) {
+    const auto& arc = _net.arc[i];
+    (arc.is_input ? inputs : outputs)
+        .push_back({arc.transition, {arc.place, color(arc.color)}});
+  }
+  input_n = ArcTable(_net.transition_count, inputs);
+  output_n = ArcTable(_net.transition_count, outputs);
+  initial_tokens.reserve(_net.token_count);
+  for (size_t i = 0; i < _net.token_count; i++) {
+    const auto& token = _net.initial_marking[i];
+    initial_tokens.push_back({token.place, color(token.color)});
+  }
+  max_in_flight.assign(_net.max_in_flight,
+                       _net.max_in_flight + _net.transition_count);
+  capacity.assign(_net.capacity, _net.capacity + _net.place_count);
+  compile();
+}
+
+void CompiledNet::compile() {
+  // sorting puts duplicate arcs next to each other, which DenseMarking relies
+  // on to determine the required token count in one pass.
+  input_n.sortRows();
+  p_to_ts_n = createReversePlaceToTransitionLookup(place.size(), input_n);
+  place_index = createIndexLookup(place);
+  transition_index = createIndexLookup(transition);
+  if (EnablingEngine::isBitParallel(input_n)) {
+    enabling = EnablingEngine(input_n);
+  }
+}
+
+std::vector<AugmentedToken> CompiledNet::toTokens(
+    const Marking& marking) const noexcept {
+  std::vector<AugmentedToken> tokens;
+  tokens.reserve(marking.size());
+  for (const auto& [p, c] : marking) {
+    // like toIndex, unknown places map to the amount of places.
+    const auto it = place_index.find(p);
+    tokens.push_back({it != place_index.end() ? it->second : place.size(), c});
+  }
+  return tokens;
+}
+
+size_t CompiledNet::transitionIndex(std::string_view t) const noexcept {
+  const auto it = transition_index.find(t);
+  return it != transition_index.end() ? it->second : transition.size();
+}
+
+Petri::PTNet::PTNet(std::shared_ptr<const CompiledNet> _compiled)
+    : compiled(std::move(_compiled)),
+      transition(compiled->transition),
+      place(compiled->place),
+      input_n(compiled->input_n),
+      output_n(compiled->output_n),
+      p_to_ts_n(compiled->p_to_ts_n),
+      priority(compiled->priority),
+      initial_tokens(compiled->initial_tokens) {
+  store.reserve(transition.size());
+  for (size_t t = 0; t < transition.size(); t++) {
+    store.emplace_back(identity<DirectMutation>{});
+  }
+}
+
 Petri::Petri(const Net& _net, const PriorityTable& _priority,
              const Marking& _initial_tokens, const Marking& _final_marking,
              const std::string& _case_id,
              std::shared_ptr<TaskSystem> threadpool)
-    : log({}),
+    : Petri(std::make_shared<const CompiledNet>(_net, _priority,
+                                                _initial_tokens),
+            _final_marking, _case_id, threadpool) {}
+
+Petri::Petri(const StaticNetView& _net, const Marking& _final_marking,
+             const std::string& _case_id,
+             std::shared_ptr<TaskSystem> threadpool)
+    : Petri(std::make_shared<const CompiledNet>(_net), _final_marking,
+            _case_id, threadpool) {}
+
+Petri::Petri(std::shared_ptr<const CompiledNet> _net,
+             const Marking& _final_marking, const std::string& _case_id,
+             std::shared_ptr<TaskSystem> threadpool)
+    : net(std::move(_net)),
+      tokens(net.place.size()),
+      enabling(net.compiled->enabling),
+      ready_transitions(net.transition.size()),
+      log({}),
       state(Scheduled),
       case_id(_case_id),
       thread_id_(std::nullopt),
       reducer_queue(
           std::make_shared<moodycamel::BlockingConcurrentQueue<Reducer>>(128)),
-      pool(threadpool) {
+      pool(threadpool),
+      max_batch_size(1024),
+      delays(net.transition.size(), Clock::duration::zero()),
+      timeouts(net.transition.size(), Clock::duration::zero()),
+      max_in_flight(net.compiled->max_in_flight),
+      capacity(net.compiled->capacity),
+      is_bounded(false),
+      has_room(false),
+      completion_queue(std::make_shared<CompletionQueue>(128)),
+      is_draining(false),
+      parent(nullptr) {
+  completion_queue->setWake(
+      [reducers = reducer_queue] { reducers->enqueue(Reducer{}); });
   log.reserve(1000);
-  tokens.reserve(100);
-  scheduled_callbacks.reserve(10);
-
-  std::tie(net.transition, net.place, net.store) = convert(_net);
-  std::tie(net.input_n, net.output_n) = populateIoLookups(_net, net.place);
-  net.p_to_ts_n = createReversePlaceToTransitionLookup(
-      net.place.size(), net.transition.size(), net.input_n);
-  net.priority = createPriorityLookup(net.transition, _priority);
-  net.initial_tokens = toTokens(_initial_tokens);
-  tokens = net.initial_tokens;
-  final_marking = toTokens(_final_marking);
+  enabling.watch(tokens);
+  tokens.setGoal(toTokens(_final_marking));
+  tokens.reset(net.initial_tokens);
 }
 
 std::vector<AugmentedToken> Petri::toTokens(
     const Marking& marking) const noexcept {
-  std::vector<AugmentedToken> tokens;
-  for (const auto& [p, c] : marking) {
-    tokens.push_back({toIndex(net.place, p), c});
-  }
-  return tokens;
+  return net.compiled->toTokens(marking);
 }
 
 void Petri::fireSynchronous(const size_t t) {
   const auto& task = net.store[t];
-  const auto& lookup_t = net.output_n[t];
+  const auto lookup_t = net.output_n[t];
   const auto now = Clock::now();
   log.push_back({t, Started, now});
   auto result = fire(task);
   log.push_back({t, result, now});
   for (const auto& [p, c] : lookup_t) {
-    tokens.push_back({p, result});
+    tokens.add(p, result);
+  }
+}
+
+namespace {
+
+/**
+ * @brief Passes a Completion from the threadpool to the event loop, and wakes
+ * up the loop if it waits. Once the Completion is queued the Petri may be
+ * gone, so only the queues are used.
+ *
+ * @param completions
+ * @param reducers
+ * @param completion
+ */
+void deliver(CompletionQueue& completions,
+             moodycamel::BlockingConcurrentQueue<Reducer>& reducers,
+             const Completion& completion) {
+  if (!completions.tryEnqueue(completion)) {
+    // the ring is full; the reducer queue can grow.
+    reducers.enqueue([completion](Petri& model) {
+      model.complete(completion, Clock::now());
+    });
+    completions.signal();
+  }
+  if (completions.takeWaiter()) {
+    completions.wake();
+  }
+}
+
+/**
+ * @brief Passes a Reducer to the event loop, and wakes up the loop if it waits.
+ * Like deliver, it only uses the queues.
+ *
+ * @param completions
+ * @param reducers
+ * @param reducer
+ */
+void post(CompletionQueue& completions,
+          moodycamel::BlockingConcurrentQueue<Reducer>& reducers,
+          Reducer&& reducer) {
+  reducers.enqueue(std::move(reducer));
+  completions.signal();
+  if (completions.takeWaiter()) {
+    completions.wake();
+  }
+}
+
+/**
+ * @brief Claims the Deadline of a Callback that completed.
+ *
+ * @param deadline may be nullptr if the Callback has no deadline
+ * @return true if the Callback completed in time
+ * @return false if it timed out, and its result has to be dropped
+ */
+bool claim(Deadline* deadline) {
+  if (deadline == nullptr) {
+    return true;
+  }
+  if (deadline->is_claimed.exchange(true)) {
+    return false;
   }
+  // the run still awaits this Callback, so the pool is still there.
+  deadline->pool.cancelTimer(deadline->timer);
+  return true;
 }
 
+}  // namespace
+
 void Petri::fireAsynchronous(const size_t t_i) {
   // register that we schedule a particular transition
-  scheduled_callbacks.push_back(t_i);
-  log.push_back({t_i, Scheduled, Clock::now()});
-  // defer execution of the transition to the threadpool
-  pool->push([t_i, this] {
-    // log the start on the petri loop;
-    reducer_queue->enqueue([t_i, t_start = Clock::now()](Petri& model) {
-      model.log.push_back({t_i, Started, t_start});
+  const auto now = Clock::now();
+  const auto instance = scheduled_callbacks.insert(t_i, now);
+  log.push_back({t_i, Scheduled, now, instance});
+  if (delays[t_i] > Clock::duration::zero()) {
+    // the delay costs no thread: the timer wheel of the threadpool hands the
+    // instance back to this loop once it expires.
+    const auto timer = pool->callAfter(delays[t_i], [this, instance] {
+      post([instance](Petri& model) { model.expire(instance); });
     });
+    auto& delayed = *scheduled_callbacks.find(instance);
+    delayed.is_delayed = true;
+    delayed.delay_timer = timer;
+    return;
+  }
+  dispatch(t_i, instance);
+}
 
-    // fire the transition and defer a reducer to the petri loop to update the
-    // marking and log
-    reducer_queue->enqueue([t_i, result = fire(net.store[t_i])](Petri& model) {
-      // if it is in the active transition set it means it is finished and
-      // we should process it.
-      const auto t_end = model.net.store[t_i].getEndTime();
-      const auto it = std::find(model.scheduled_callbacks.begin(),
-                                model.scheduled_callbacks.end(), t_i);
-      if (it != model.scheduled_callbacks.end()) {
-        const auto& place_list = model.net.output_n[t_i];
-        if (model.tokens.size() + place_list.size() > model.tokens.capacity()) {
-          model.tokens.reserve(
-              std::max(2 * model.tokens.size(),
-                       model.tokens.size() + place_list.size()));
-        }
-        for (const auto& [p, c] : place_list) {
-          model.tokens.emplace_back(p, result);
-        }
-        std::swap(*std::prev(model.scheduled_callbacks.end()), *it);
-        model.scheduled_callbacks.pop_back();
+void Petri::expire(ActiveSet::Id instance) {
+  const auto delayed = scheduled_callbacks.find(instance);
+  if (delayed == nullptr || !delayed->is_delayed) {
+    return;
+  }
+  delayed->is_delayed = false;
+  const auto t_i = delayed->transition;
+  const auto start = Clock::now();
+  if (state == Canceled) {
+    complete({static_cast<uint32_t>(t_i), Canceled, start, start, instance,
+              false, false},
+             start);
+  } else if (isSynchronous(net.store[t_i])) {
+    const auto result = fire(net.store[t_i]);
+    const auto end = Clock::now();
+    complete({static_cast<uint32_t>(t_i), result, start, end, instance}, end);
+  } else {
+    dispatch(t_i, instance);
+  }
+}
+
+std::shared_ptr<Deadline> Petri::arm(const size_t t_i,
+                                     ActiveSet::Id instance) {
+  if (timeouts[t_i] == Clock::duration::zero()) {
+    return nullptr;
+  }
+  auto deadline = std::make_shared<Deadline>(net.store[t_i], completion_queue,
+                                             reducer_queue, *pool);
+  deadline->timer = pool->callAfter(timeouts[t_i], [instance, deadline] {
+    if (!deadline->is_claimed.exchange(true)) {
+      symmetri::post(*deadline->completions, *deadline->reducers,
+                     [instance](Petri& model) { model.timeout(instance); });
+    }
+  });
+  return deadline;
+}
+
+void Petri::timeout(ActiveSet::Id instance) {
+  const auto active = scheduled_callbacks.find(instance);
+  if (active == nullptr) {
+    return;
+  }
+  // the Callback drops its result whenever it completes, so the transition
+  // ends right away. Cancelling it would also cancel the other instances of
+  // the transition that run, as they share the Callback; those keep running.
+  const auto t_i = active->transition;
+  const auto is_sole = std::none_of(
+      scheduled_callbacks.begin(), scheduled_callbacks.end(),
+      [&](const ActiveSet::Instance& other) {
+        return other.transition == t_i && other.id != instance &&
+               !other.is_delayed;
+      });
+  if (is_sole) {
+    cancel(net.store[t_i]);
+  }
+  release(t_i);
+  for (const auto& [p, c] : net.output_n[t_i]) {
+    tokens.add(p, TimedOut);
+  }
+  scheduled_callbacks.erase(instance);
+  log.push_back({t_i, TimedOut, Clock::now(), instance});
+}
+
+void Petri::dispatch(const size_t t_i, ActiveSet::Id instance) {
+  auto deadline = arm(t_i, instance);
+  // defer execution of the transition to the threadpool, which may schedule it
+  // by the priority of the transition.
+  if (isNested(net.store[t_i])) {
+    // a nested net is started right away, and then runs as a sub-state of
+    // this loop, so it costs no thread and no hand-over to the threadpool.
+    const auto start = Clock::now();
+    nesting = this;
+    fire(net.store[t_i], [t_i, instance, start, deadline,
+                          completions = completion_queue,
+                          reducers = reducer_queue](Token result) {
+      if (claim(deadline.get())) {
+        deliver(*completions, *reducers,
+                {static_cast<uint32_t>(t_i), result, start, Clock::now(),
+                 instance, true});
+      }
+    });
+    nesting = nullptr;
+    return;
+  }
+  if (deadline != nullptr) {
+    // the run ends when the deadline expires, possibly before the task runs,
+    // so the task only uses what the Deadline keeps alive. A Callback that
+    // timed out before it started is not fired at all.
+    pool->push(
+        [t_i, instance, deadline = std::move(deadline)] {
+          if (deadline->is_claimed.load()) {
+            return;
+          }
+          const auto start = Clock::now();
+          if (isSuspendable(deadline->callback)) {
+            fire(deadline->callback,
+                 [t_i, instance, start, deadline](Token result) {
+                   if (claim(deadline.get())) {
+                     deliver(*deadline->completions, *deadline->reducers,
+                             {static_cast<uint32_t>(t_i), result, start,
+                              Clock::now(), instance, true});
+                   }
+                 });
+            return;
+          }
+          const auto result = fire(deadline->callback);
+          const auto end = Clock::now();
+          if (claim(deadline.get())) {
+            deliver(*deadline->completions, *deadline->reducers,
+                    {static_cast<uint32_t>(t_i), result, start, end, instance,
+                     true});
+          }
+        },
+        net.priority[t_i]);
+    return;
+  }
+  // without a deadline the run awaits every instance, so the Petri outlives
+  // these tasks. They have to fit inline, so they take the queues from the
+  // Petri once they run.
+  if (isSuspendable(net.store[t_i])) {
+    // the task only starts the Callback; the Continuation delivers the result
+    // whenever it is done, without occupying a thread in the meantime.
+    pool->push(
+        [t_i, instance, this] {
+          const auto start = Clock::now();
+          fire(net.store[t_i], [t_i, instance, start,
+                                completions = completion_queue,
+                                reducers = reducer_queue](Token result) {
+            deliver(*completions, *reducers,
+                    {static_cast<uint32_t>(t_i), result, start, Clock::now(),
+                     instance, true});
+          });
+        },
+        net.priority[t_i]);
+    return;
+  }
+  pool->push(
+      [t_i, instance, this] {
+        const auto completions = completion_queue;
+        const auto reducers = reducer_queue;
+        const auto start = Clock::now();
+        const auto result = fire(net.store[t_i]);
+        const auto end = Clock::now();
+        deliver(*completions, *reducers,
+                {static_cast<uint32_t>(t_i), result, start, end, instance,
+                 true});
+      },
+      net.priority[t_i]);
+}
+
+void Petri::post(Reducer&& reducer) {
+  // once the Reducer is queued the Petri may finish and be gone, so the queues
+  // are kept alive by this call.
+  const auto completions = completion_queue;
+  const auto reducers = reducer_queue;
+  symmetri::post(*completions, *reducers, std::move(reducer));
+}
+
+void Petri::complete(const Completion& completion,
+                     Clock::time_point applied) {
+  const size_t t_i = completion.transition;
+  const auto instance = completion.instance;
+  if (completion.is_started) {
+    log.push_back({t_i, Started, completion.start, instance});
+  }
+  // if the instance is still active it is finished now and we should process
+  // it.
+  const auto active = scheduled_callbacks.find(instance);
+  if (active != nullptr) {
+    // firings that were cancelled or ran on this loop after their delay did
+    // not pass through the TaskSystem, so they have no latencies.
+    if (completion.is_dispatched) {
+      const auto nanoseconds = [](Clock::duration d) {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::max(d, Clock::duration::zero()))
+                .count());
       };
-      model.log.push_back({t_i, result, t_end});
+      // the histograms are only allocated for transitions that fire, so an
+      // instance costs nothing for them until then.
+      if (latencies.empty()) {
+        latencies.resize(net.transition.size());
+      }
+      auto& latency = latencies[t_i];
+      if (latency == nullptr) {
+        latency = std::make_unique<FiringLatencies>();
+      }
+      latency->queueing.record(
+          nanoseconds(completion.start - active->scheduled));
+      latency->service.record(nanoseconds(completion.end - completion.start));
+      latency->delivery.record(nanoseconds(applied - completion.end));
+    }
+    scheduled_callbacks.erase(instance);
+    release(t_i);
+    for (const auto& [p, c] : net.output_n[t_i]) {
+      tokens.add(p, completion.result);
+    }
+  }
+  log.push_back({t_i, completion.result, completion.end, instance});
+}
+
+size_t Petri::applyEvents(size_t budget) {
+  size_t applied = 0;
+  // the Reducers signalled so far are drained, unless the budget runs out.
+  const auto signals = completion_queue->signals();
+  reducer_queue->try_dequeue_bulk(std::back_inserter(reducer_buffer), budget);
+  if (reducer_buffer.size() < budget) {
+    completion_queue->acknowledge(signals);
+  }
+  for (const auto& f : reducer_buffer) {
+    if (f) {
+      f(*this);
+      applied++;
+    }
+  }
+  budget -= reducer_buffer.size();
+  reducer_buffer.clear();
+
+  const auto reduced = applied;
+  Clock::time_point now;
+  Completion completion;
+  while (budget-- > 0 && completion_queue->tryDequeue(completion)) {
+    // one stamp serves the batch, as reading the clock costs about as much as
+    // applying a Completion.
+    if (applied == reduced) {
+      now = Clock::now();
+    }
+    complete(completion, now);
+    applied++;
+  }
+  return applied;
+}
+
+size_t Petri::processEvents(int64_t timeout_usecs) {
+  auto applied = applyEvents(max_batch_size);
+  const auto deadline =
+      Clock::now() + std::chrono::microseconds(std::max<int64_t>(
+                         timeout_usecs, 0));
+  Reducer f;
+  while (applied == 0) {
+    const auto remaining =
+        timeout_usecs < 0
+            ? int64_t{-1}
+            : std::chrono::duration_cast<std::chrono::microseconds>(
+                  deadline - Clock::now())
+                  .count();
+    if (timeout_usecs >= 0 && remaining <= 0) {
+      break;
+    }
+    if (poll(wait_policy, [this] {
+          return !completion_queue->empty() || reducer_queue->size_approx() > 0;
+        })) {
+      applied += applyEvents(max_batch_size);
+      continue;
+    }
+    // completions do not wake up the loop by themselves; a completion that is
+    // queued after the wait is announced sends an empty Reducer.
+    size_t budget = max_batch_size;
+    if (completion_queue->prepareWait() &&
+        reducer_queue->wait_dequeue_timed(f, remaining)) {
+      budget--;
+      if (f) {
+        f(*this);
+        applied++;
+      }
+    }
+    completion_queue->finishWait();
+    applied += applyEvents(budget);
+  }
+
+  if (applied > 0) {
+    size_t bucket = 0;
+    while ((applied >> (bucket + 1)) != 0 &&
+           bucket + 1 < batch_statistics.histogram.size()) {
+      bucket++;
+    }
+    batch_statistics.histogram[bucket]++;
+    batch_statistics.batches++;
+    batch_statistics.events += applied;
+    batch_statistics.largest = std::max(batch_statistics.largest, applied);
+  }
+  return applied;
+}
+
+void Petri::discardEvents() {
+  Completion completion;
+  while (completion_queue->tryDequeue(completion)) {
+  }
+  const auto signals = completion_queue->signals();
+  Reducer f;
+  while (reducer_queue->try_dequeue(f)) {
+  }
+  completion_queue->acknowledge(signals);
+}
+
+void Petri::start(bool is_suspended) {
+  scheduled_callbacks.clear();
+  tokens.reset(net.initial_tokens);
+  state = Started;
+  is_draining = false;
+  resetBounds();
+  discardEvents();
+  if (is_suspended && parent.load() != nullptr) {
+    // the parent outlives the run, as it waits for its Callbacks.
+    completion_queue->setWake([this, outer = parent.load()] {
+      outer->post([this](Petri&) { drive(); });
     });
-  });
+  } else if (is_suspended) {
+    completion_queue->setWake([this] { pool->push([this] { drive(); }); });
+  } else {
+    completion_queue->setWake(
+        [reducers = reducer_queue] { reducers->enqueue(Reducer{}); });
+  }
+}
+
+void Petri::drive() {
+  const auto outer = std::exchange(driving, this);
+  do {
+    processEvents(0);
+    if (!is_draining) {
+      if (tokens.goalReached()) {
+        state = Success;
+      }
+      if (state == Started) {
+        fireTransitions();
+        if (tokens.goalReached()) {
+          state = Success;
+        } else if (scheduled_callbacks.empty()) {
+          state = Deadlocked;
+        }
+      }
+      // like a blocking run, a finished run waits for its Callbacks.
+      if (!(state == Started || state == Paused)) {
+        if (tokens.goalReached()) {
+          state = Success;
+        }
+        is_draining = true;
+      }
+    }
+    if (is_draining && scheduled_callbacks.empty()) {
+      driving = outer;
+      finish();
+      return;
+    }
+  } while (!park());
+  driving = outer;
+}
+
+bool Petri::park() {
+  // a producer that takes the announcement schedules the next drive. If there
+  // are events after all, the announcement is taken back, unless a producer
+  // was first. Once announced, the run may finish on another thread and the
+  // Petri be gone, so the queue is kept alive by this call.
+  const auto completions = completion_queue;
+  return completions->prepareWait() || !completions->takeWaiter();
 }
 
-void deductMarking(std::vector<AugmentedToken>& tokens,
-                   const SmallVectorInput& inputs) {
-  for (const auto& place : inputs) {
-    tokens.erase(std::find(tokens.begin(), tokens.end(), place));
+void Petri::finish() {
+  auto done = std::move(continuation);
+  continuation = nullptr;
+  const auto result = state;
+  parent.store(nullptr);
+  thread_id_.store(std::nullopt);
+  done(result);
+}
+
+bool Petri::isDrivenHere() const noexcept {
+  if (driving == nullptr) {
+    return false;
+  }
+  for (auto p = this; p != nullptr; p = p->parent.load()) {
+    if (p == driving) {
+      return true;
+    }
   }
+  return false;
 }
 
 void Petri::fireTransitions() {
-  auto ts = possibleTransitions(tokens, net.input_n, net.p_to_ts_n);
-  std::sort(ts.begin(), ts.end(), [&](size_t a, size_t b) {
-    return net.priority[a] > net.priority[b];
-  });
+  possibleTransitions(tokens, net.input_n, net.p_to_ts_n, net.priority,
+                      enabling, ready_transitions);
+  tokens.clearDirty();
+  retryThrottled();
 
   // loop
-  while (!ts.empty()) {
-    const auto t_idx = ts.front();
-    const bool is_synchronous = isSynchronous(net.store[t_idx]);
-    const bool can_fire = canFire(net.input_n[t_idx], tokens);
+  while (!ready_transitions.empty()) {
+    const auto t_idx = ready_transitions.top();
+    // a delayed transition fires asynchronously, even if its Callback is
+    // synchronous.
+    const bool is_synchronous = isSynchronous(net.store[t_idx]) &&
+                                delays[t_idx] == Clock::duration::zero();
+    const auto inputs = net.input_n[t_idx];
+    const bool can_fire = enabling.canFire(t_idx, inputs, tokens);
+
+    // an enabled transition without room waits aside until a completion or a
+    // consumption makes room; its tokens may not change in the meantime.
+    if (can_fire && is_bounded && !fitsBounds(t_idx)) {
+      ready_transitions.pop();
+      if (is_throttled[t_idx] == 0) {
+        is_throttled[t_idx] = 1;
+        throttled.push_back(t_idx);
+      }
+      continue;
+    }
 
     // fire!
     if (can_fire) {
-      deductMarking(tokens, net.input_n[t_idx]);
+      tokens.deduct(inputs);
+      if (is_bounded) {
+        admit(t_idx, is_synchronous);
+      }
       std::invoke(
           is_synchronous ? &Petri::fireSynchronous : &Petri::fireAsynchronous,
           this, t_idx);
@@ -190,35 +788,159 @@ void Petri::fireTransitions() {
 
     // If the transition couldn't be fired or can not be fired again, remove the
     // transition
-    if (not can_fire || not canFire(net.input_n[t_idx], tokens)) {
-      std::rotate(ts.begin(), ts.begin() + 1, ts.end());
-      ts.pop_back();
+    if (not can_fire || not enabling.canFire(t_idx, inputs, tokens)) {
+      ready_transitions.pop();
     }
 
     // if the fired transition was synchronous, we have to check if the new
-    // tokens enable possible transitions
+    // tokens enable possible transitions. The ReadyQueue keeps them ordered by
+    // priority.
     if (can_fire && is_synchronous) {
-      for (const auto& [p, c] : net.output_n[t_idx]) {
-        for (const auto& new_transition : net.p_to_ts_n[p]) {
-          if (std::find(ts.begin(), ts.end(), new_transition) == ts.end()) {
-            ts.push_back(new_transition);
-          }
-        }
+      possibleTransitions(tokens, net.input_n, net.p_to_ts_n, net.priority,
+                          enabling, ready_transitions);
+      tokens.clearDirty();
+    }
+    retryThrottled();
+  }
+
+  return;
+}
+
+void Petri::resetBounds() {
+  is_bounded =
+      std::any_of(max_in_flight.begin(), max_in_flight.end(),
+                  [](uint32_t limit) { return limit > 0; }) ||
+      std::any_of(capacity.begin(), capacity.end(),
+                  [](uint32_t limit) { return limit > 0; });
+  place_bounds.clear();
+  in_flight.clear();
+  reserved.clear();
+  throttled.clear();
+  is_throttled.clear();
+  held_inputs.clear();
+  has_room = false;
+  if (!is_bounded) {
+    return;
+  }
+
+  place_bounds.resize(net.transition.size());
+  for (size_t t = 0; t < net.transition.size(); t++) {
+    auto& bounds = place_bounds[t];
+    const auto bound = [&](size_t p) -> PlaceBound& {
+      const auto it =
+          std::find_if(bounds.begin(), bounds.end(),
+                       [p](const PlaceBound& b) { return b.place == p; });
+      return it != bounds.end() ? *it
+                                : bounds.emplace_back(PlaceBound{p, 0, 0});
+    };
+    for (const auto& [p, c] : net.input_n[t]) {
+      if (capacity[p] > 0) {
+        bound(p).consumed++;
+      }
+    }
+    for (const auto& [p, c] : net.output_n[t]) {
+      if (capacity[p] > 0) {
+        bound(p).produced++;
       }
-      // we have to sort by priority again because we added priorities.
-      std::sort(ts.begin(), ts.end(), [&](size_t a, size_t b) {
-        return net.priority[a] > net.priority[b];
+    }
+  }
+  in_flight.resize(net.transition.size(), 0);
+  reserved.resize(net.place.size(), 0);
+  is_throttled.resize(net.transition.size(), 0);
+}
+
+bool Petri::fitsBounds(const size_t t) const noexcept {
+  if (max_in_flight[t] > 0 && in_flight[t] >= max_in_flight[t]) {
+    return false;
+  }
+  return std::all_of(
+      place_bounds[t].begin(), place_bounds[t].end(),
+      [this](const PlaceBound& b) {
+        return uint64_t(tokens.count(b.place)) + reserved[b.place] +
+                   b.produced <=
+               uint64_t(capacity[b.place]) + b.consumed;
       });
+}
+
+void Petri::admit(const size_t t, bool is_synchronous) noexcept {
+  for (const auto& b : place_bounds[t]) {
+    if (!is_synchronous) {
+      reserved[b.place] += b.produced;
     }
+    has_room |= b.consumed > b.produced;
+  }
+  if (!is_synchronous) {
+    in_flight[t]++;
+  }
+}
+
+void Petri::release(const size_t t) noexcept {
+  if (!is_bounded) {
+    return;
+  }
+  for (const auto& b : place_bounds[t]) {
+    reserved[b.place] -= b.produced;
   }
+  in_flight[t]--;
+  has_room |= max_in_flight[t] > 0;
+}
 
-  return;
+void Petri::retryThrottled() {
+  if (!has_room) {
+    return;
+  }
+  has_room = false;
+  for (const auto t : throttled) {
+    is_throttled[t] = 0;
+    ready_transitions.push(t, net.priority[t]);
+  }
+  throttled.clear();
+  // input transitions are not made ready by tokens, so the held ones fire
+  // here, in order, as long as they fit.
+  size_t held = 0;
+  for (const auto t : held_inputs) {
+    if (fitsBounds(t)) {
+      admit(t, false);
+      fireAsynchronous(t);
+    } else {
+      held_inputs[held++] = t;
+    }
+  }
+  held_inputs.resize(held);
+}
+
+void Petri::fireInput(const size_t t) {
+  if (is_bounded) {
+    if (!fitsBounds(t)) {
+      held_inputs.push_back(t);
+      return;
+    }
+    admit(t, false);
+  }
+  fireAsynchronous(t);
+}
+
+Latencies Petri::getLatencies() const {
+  Latencies snapshot{case_id, {}};
+  snapshot.transitions.reserve(net.transition.size());
+  for (size_t t = 0; t < net.transition.size(); t++) {
+    auto& transition = snapshot.transitions.emplace_back();
+    transition.transition = net.transition[t];
+    if (t < latencies.size() && latencies[t] != nullptr) {
+      transition.queueing = latencies[t]->queueing;
+      transition.service = latencies[t]->service;
+      transition.delivery = latencies[t]->delivery;
+    }
+  }
+  return snapshot;
 }
 
 Marking Petri::getMarking() const {
+  const auto augmented_tokens = tokens.toTokens();
   Marking marking;
-  marking.reserve(tokens.size());
-  std::transform(tokens.cbegin(), tokens.cend(), std::back_inserter(marking),
+  marking.reserve(augmented_tokens.size());
+  std::transform(augmented_tokens.cbegin(), augmented_tokens.cend(),
+                 std::back_inserter(marking),
                  [&](auto place_index) -> std::pair<std::string, Token> {
                    return {net.place[std::get<size_t>(place_index)],
                            std::get<Token>(place_index)};
@@ -229,10 +951,10 @@ Marking Petri::getMarking() const {
 std::vector<Transition> Petri::getActiveTransitions() const {
   std::vector<Transition> active_transitions;
   active_transitions.reserve(scheduled_callbacks.size());
-  std::transform(scheduled_callbacks.cbegin(), scheduled_callbacks.cend(),
+  std::transform(scheduled_callbacks.begin(), scheduled_callbacks.end(),
                  std::back_inserter(active_transitions),
-                 [&](auto transition_index) -> std::string {
-                   return net.transition[transition_index];
+                 [&](const auto& instance) -> std::string {
+                   return net.transition[instance.transition];
                  });
   return active_transitions;
 }
@@ -240,8 +962,8 @@ std::vector<Transition> Petri::getActiveTransitions() const {
 Eventlog Petri::getLogInternal() const {
   Eventlog eventlog;
   eventlog.reserve(log.size());
-  for (const auto& [t_i, result, time] : log) {
-    eventlog.push_back({case_id, net.transition[t_i], result, time});
+  for (const auto& [t_i, result, time, instance] : log) {
+    eventlog.push_back({case_id, net.transition[t_i], result, time, instance});
   }
 
   // get event log from parent nets:
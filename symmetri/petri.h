@@ -12,34 +12,37 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "active_set.h"
+#include "completion_queue.h"
+#include "dense_marking.h"
+#include "enabling_engine.h"
 #include "externals/blockingconcurrentqueue.h"
 #include "externals/small_vector.hpp"
+#include "ready_queue.h"
 #include "symmetri/callback.h"
 #include "symmetri/colors.hpp"
+#include "symmetri/histogram.h"
+#include "symmetri/static_net.hpp"
 #include "symmetri/tasks.h"
 #include "symmetri/types.h"
 
 namespace symmetri {
 
-/**
- * @brief AugmentedToken describes a token with a color in a
- * particular place.
- *
- */
-using AugmentedToken = std::tuple<size_t, Token>;
-
 /**
  * @brief a minimal Event representation.
  *
  */
 struct SmallEvent {
-  size_t transition;        ///< The transition that generated the event
-  Token state;              ///< The result of the event
-  Clock::time_point stamp;  ///< The timestamp of the event
+  size_t transition;           ///< The transition that generated the event
+  Token state;                 ///< The result of the event
+  Clock::time_point stamp;     ///< The timestamp of the event
+  ActiveSet::Id instance = 0;  ///< The firing, 0 if it was synchronous
 };
 
 /**
@@ -71,18 +74,38 @@ using SmallVectorInput = gch::small_vector<AugmentedToken, 4>;
 size_t toIndex(const std::vector<std::string>& m, const std::string& s);
 
 /**
- * @brief calculates a list of possible transitions given the current
- * token-distribution. It returns a list of transitions sorted by priority. The
- * first element being the high priority.
+ * @brief Creates a hash map from the names of places or transitions to their
+ * index, so that looking up many names is O(1) per name instead of a linear
+ * search like toIndex. The map refers to the strings in `names`, so it may not
+ * outlive them. If a name occurs more than once, it maps to the first
+ * occurrence.
+ *
+ * @param names
+ * @return std::unordered_map<std::string_view, size_t>
+ */
+std::unordered_map<std::string_view, size_t> createIndexLookup(
+    const std::vector<std::string>& names);
+
+/**
+ * @brief adds the possible transitions, given the current token-distribution,
+ * to the ReadyQueue. Only the transitions that consume from the dirty places of
+ * the marking are examined, as these are the only ones that can have become
+ * enabled since the dirty places were last cleared.
+ *
+ * If a large part of the places is dirty and the engine supports it, all
+ * transitions are evaluated at once instead.
  *
  * @param tokens
+ * @param input_n
  * @param p_to_ts_n
- * @return gch::small_vector<size_t, 32>
+ * @param priority
+ * @param engine the engine that checks if transitions are enabled
+ * @param ready the queue to which the enabled transitions are added
  */
-gch::small_vector<size_t, 32> possibleTransitions(
-    const std::vector<AugmentedToken>& tokens,
-    const std::vector<SmallVectorInput>& input_n,
-    const std::vector<SmallVector>& p_to_ts_n);
+void possibleTransitions(const DenseMarking& tokens, const ArcTable& input_n,
+                         const CsrTable<uint32_t>& p_to_ts_n,
+                         const std::vector<int8_t>& priority,
+                         const EnablingEngine& engine, ReadyQueue& ready);
 
 /**
  * @brief Takes a vector of input places (pre-conditions) and the current token
@@ -97,6 +120,14 @@ gch::small_vector<size_t, 32> possibleTransitions(
 bool canFire(const SmallVectorInput& pre,
              const std::vector<AugmentedToken>& tokens);
 
+/**
+ * @brief Get a 32 bit representation of the id of the calling thread, which is
+ * stored in Petri::thread_id_ while a Petri runs.
+ *
+ * @return unsigned int
+ */
+unsigned int getThreadId();
+
 /**
  * @brief Forward declaration of the Petri-class
  *
@@ -104,11 +135,53 @@ bool canFire(const SmallVectorInput& pre,
 struct Petri;
 
 /**
- * @brief A Reducer updates the Petri-object. Reducers are used to process the
- * post-callback marking mutations.
+ * @brief A Reducer updates the Petri-object. Reducers are used for everything
+ * other than completions that has to run on the Petri event loop, e.g.
+ * cancelling, pausing or queries. An empty Reducer only wakes up the loop.
  */
 using Reducer = std::function<void(Petri&)>;
 
+/**
+ * @brief Deadline is shared by an asynchronous Callback and the timer of its
+ * deadline. Whichever claims it first ends the transition: the Callback with
+ * its result, or the timer with TimedOut. The other one then does nothing.
+ * The run and its PetriNet may be gone once the deadline expired, so the
+ * Deadline keeps the Callback and the queues alive for the task that fires it.
+ *
+ */
+struct Deadline {
+  Deadline(const Callback& callback,
+           std::shared_ptr<CompletionQueue> completions,
+           std::shared_ptr<moodycamel::BlockingConcurrentQueue<Reducer>>
+               reducers,
+           TaskSystem& pool)
+      : callback(share(callback)),
+        completions(std::move(completions)),
+        reducers(std::move(reducers)),
+        pool(pool) {}
+
+  std::atomic<bool> is_claimed{false};  ///< Set by the first to finish
+  TaskSystem::TimerId timer = 0;        ///< Cancelled if the Callback is first
+  const Callback callback;  ///< Shares the Callback of the transition
+  const std::shared_ptr<CompletionQueue>
+      completions;  ///< The results of asynchronous Callbacks of the run
+  const std::shared_ptr<moodycamel::BlockingConcurrentQueue<Reducer>>
+      reducers;  ///< The Reducers of the run
+  TaskSystem& pool;  ///< Only used by the one that claims the Deadline first,
+                     ///< while the run still awaits the Callback
+};
+
+/**
+ * @brief PlaceBound is the effect of firing a transition on a place with a
+ * capacity.
+ *
+ */
+struct PlaceBound {
+  size_t place;       ///< The place with the capacity
+  uint32_t consumed;  ///< The tokens the transition takes from it
+  uint32_t produced;  ///< The tokens the transition puts in it
+};
+
 /**
  * @brief deducts the set input from the current token distribution
  *
@@ -117,6 +190,99 @@ using Reducer = std::function<void(Petri&)>;
 void deductMarking(std::vector<AugmentedToken>& tokens,
                    const SmallVectorInput& inputs);
 
+/**
+ * @brief CompiledNet holds the immutable structure of a Petri net: the names,
+ * the arc tables, the reverse lookup, the priorities, the initial marking, the
+ * default bounds and the enabling engine. It does not depend on the marking
+ * or the Callbacks, so it can be shared by any amount of Petri instances of
+ * the same net. It refers to its own names, so it can not be copied or moved;
+ * it is created in place by std::make_shared.
+ *
+ */
+struct CompiledNet {
+  /**
+   * @brief Compiles a multiset description of a Petri net. A lot of conversion
+   * work is done in the constructor.
+   *
+   * @param _net
+   * @param _priority
+   * @param _initial_tokens
+   * @param _max_in_flight the max-in-flight limits, by transition name
+   * @param _capacities the capacities, by place name
+   */
+  CompiledNet(const Net& _net, const PriorityTable& _priority,
+              const Marking& _initial_tokens,
+              const BoundTable& _max_in_flight = {},
+              const BoundTable& _capacities = {});
+
+  /**
+   * @brief Compiles the tables of a StaticNet. Places and transitions are
+   * already resolved to indices, so no conversion work is needed apart from
+   * resolving the color names.
+   *
+   * @param _net
+   */
+  explicit CompiledNet(const StaticNetView& _net);
+  ~CompiledNet() noexcept = default;
+  CompiledNet(CompiledNet const&) = delete;
+  CompiledNet(CompiledNet&&) noexcept = delete;
+  CompiledNet& operator=(CompiledNet const&) = delete;
+  CompiledNet& operator=(CompiledNet&&) noexcept = delete;
+
+  /**
+   * @brief Converts a marking to tokens. Unknown places map to the amount of
+   * places, like toIndex.
+   *
+   * @param marking
+   * @return std::vector<AugmentedToken>
+   */
+  std::vector<AugmentedToken> toTokens(const Marking& marking) const noexcept;
+
+  /**
+   * @brief Get the index of a transition.
+   *
+   * @param t
+   * @return size_t the index, or the amount of transitions if t is unknown
+   */
+  size_t transitionIndex(std::string_view t) const noexcept;
+
+  std::vector<std::string> transition;  ///< (ordered) list of transitions
+  std::vector<std::string> place;       ///< (ordered) list of places
+  ArcTable input_n;   ///< The inputs of every transition, sorted
+  ArcTable output_n;  ///< The outputs of every transition
+  CsrTable<uint32_t> p_to_ts_n;  ///< The consumers of every place, ascending
+  std::vector<int8_t> priority;  ///< The priority of every transition
+  std::vector<AugmentedToken> initial_tokens;  ///< The initial marking
+  std::vector<uint32_t> max_in_flight;  ///< The default limit of every
+                                        ///< transition, 0 if unbounded
+  std::vector<uint32_t> capacity;  ///< The default capacity of every place, 0
+                                   ///< if unbounded
+  std::unordered_map<std::string_view, size_t>
+      place_index;  ///< From place name to index
+  std::unordered_map<std::string_view, size_t>
+      transition_index;     ///< From transition name to index
+  EnablingEngine enabling;  ///< Checks if transitions are enabled
+
+ private:
+  /**
+   * @brief Derives the name lookups, the reverse lookup and the enabling
+   * engine from the names and the arc tables.
+   *
+   */
+  void compile();
+};
+
+/**
+ * @brief FiringLatencies holds the latency histograms of the dispatched
+ * firings of a transition. See TransitionLatencies.
+ *
+ */
+struct FiringLatencies {
+  Histogram queueing;  ///< From Scheduled until its Callback started
+  Histogram service;   ///< From the start until the end of its Callback
+  Histogram delivery;  ///< From the end of its Callback until it is applied
+};
+
 /**
  * @brief Petri is a data structure that encodes the Petri net and holds
  * pointers to the thread-pool and the reducer-queue. It is optimized for
@@ -142,6 +308,32 @@ struct Petri {
                  const Marking& _initial_tokens, const Marking& _final_marking,
                  const std::string& _case_id,
                  std::shared_ptr<TaskSystem> threadpool);
+
+  /**
+   * @brief Construct a new Petri from the tables of a StaticNet.
+   *
+   * @param _net
+   * @param _final_marking
+   * @param _case_id
+   * @param threadpool
+   */
+  explicit Petri(const StaticNetView& _net, const Marking& _final_marking,
+                 const std::string& _case_id,
+                 std::shared_ptr<TaskSystem> threadpool);
+
+  /**
+   * @brief Construct a new Petri from an already compiled net. Only the
+   * mutable state is allocated: the marking, the ready queue, the Callbacks,
+   * the log and the reducer queue.
+   *
+   * @param _net
+   * @param _final_marking
+   * @param _case_id
+   * @param threadpool
+   */
+  explicit Petri(std::shared_ptr<const CompiledNet> _net,
+                 const Marking& _final_marking, const std::string& _case_id,
+                 std::shared_ptr<TaskSystem> threadpool);
   ~Petri() noexcept = default;
   Petri(Petri const&) = delete;
   Petri(Petri&&) noexcept = delete;
@@ -167,6 +359,14 @@ struct Petri {
    */
   Marking getMarking() const;
 
+  /**
+   * @brief Get a snapshot of the latency histograms, with an entry for every
+   * transition. Transitions that did not fire have empty histograms.
+   *
+   * @return Latencies
+   */
+  Latencies getLatencies() const;
+
   /**
    * @brief Get the list of active transitions.
    * @return std::vector<Transition>
@@ -190,45 +390,54 @@ struct Petri {
   void fireTransitions();
 
   struct PTNet {
+    explicit PTNet(std::shared_ptr<const CompiledNet> _compiled);
+
+    /**
+     * @brief The shared structure of the net. The members below refer to it.
+     *
+     */
+    std::shared_ptr<const CompiledNet> compiled;
+
     /**
      * @brief (ordered) list of string representation of transitions
      *
      */
-    std::vector<std::string> transition;
+    const std::vector<std::string>& transition;
 
     /**
      * @brief (ordered) list of string representation of places
      *
      */
-    std::vector<std::string> place;
+    const std::vector<std::string>& place;
 
     /**
-     * @brief list of list of inputs to transitions. This vector is indexed like
-     * `transition`.
+     * @brief the inputs of every transition. The rows are indexed like
+     * `transition`. The inputs of a transition are sorted, so duplicate arcs
+     * are adjacent.
      *
      */
-    std::vector<SmallVectorInput> input_n;
+    const ArcTable& input_n;
 
     /**
-     * @brief list of list of outputs of transitions. This vector is indexed
-     * like `transition`.
+     * @brief the outputs of every transition. The rows are indexed like
+     * `transition`.
      *
      */
-    std::vector<SmallVectorInput> output_n;
+    const ArcTable& output_n;
 
     /**
-     * @brief list of list of transitions that have places as inputs. This
-     * vector is index like `place`
+     * @brief the transitions that have a place as input, in ascending order.
+     * The rows are indexed like `place`.
      *
      */
-    std::vector<SmallVector> p_to_ts_n;
+    const CsrTable<uint32_t>& p_to_ts_n;
 
     /**
      * @brief This vector holds priorities for all transitions. This vector is
      * index like `transition`.
      *
      */
-    std::vector<int8_t> priority;
+    const std::vector<int8_t>& priority;
 
     /**
      * @brief This is the same 'lookup table', only index using  `transition` so
@@ -236,20 +445,21 @@ struct Petri {
      *
      */
     std::vector<Callback> store;
-    std::vector<AugmentedToken> initial_tokens;  ///< The initial marking
+    const std::vector<AugmentedToken>& initial_tokens;  ///< The initial marking
 
     void registerCallback(const std::string& t, Callback&& callback) noexcept {
-      if (std::find(transition.begin(), transition.end(), t) !=
-          transition.end()) {
-        store[toIndex(transition, t)] = std::move(callback);
+      const auto t_index = compiled->transitionIndex(t);
+      if (t_index < store.size()) {
+        store[t_index] = std::move(callback);
       }
     }
   } net;  ///< Is a data-oriented design of a Petri net
 
-  std::vector<AugmentedToken> tokens;         ///< The current marking
-  std::vector<AugmentedToken> final_marking;  ///< The final marking
-  std::vector<size_t> scheduled_callbacks;    ///< List of active transitions
-  SmallLog log;                               ///< The most up to date event_log
+  DenseMarking tokens;                      ///< The current marking
+  const EnablingEngine& enabling;           ///< Checks if enabled, shared
+  ReadyQueue ready_transitions;             ///< Candidates, by priority
+  ActiveSet scheduled_callbacks;            ///< The active instances
+  SmallLog log;                             ///< The most up to date event_log
   Token state;          ///< The current state of the Petri
   std::string case_id;  ///< The unique identifier for this Petri-run
   std::atomic<std::optional<unsigned int>>
@@ -262,15 +472,240 @@ struct Petri {
                       ///< not destroyed while in use.
   std::shared_ptr<TaskSystem>
       pool;  ///< A pointer to the threadpool used to defer Callbacks.
+  size_t max_batch_size;  ///< The most events applied between two passes
+  std::vector<Clock::duration>
+      delays;  ///< The firing delay of every transition, indexed like
+               ///< `transition`
+  std::vector<Clock::duration>
+      timeouts;  ///< The deadline of every asynchronous Callback, indexed like
+                 ///< `transition`
+  std::vector<uint32_t>
+      max_in_flight;  ///< The most active Callbacks of every transition, 0 if
+                      ///< unbounded. Indexed like `transition`
+  std::vector<uint32_t> capacity;  ///< The most tokens of every place, 0 if
+                                   ///< unbounded. Indexed like `place`
+  bool is_bounded;  ///< Set during a run if any limit or capacity is set
+  std::vector<std::vector<PlaceBound>>
+      place_bounds;  ///< The capacitated places of every transition
+  std::vector<uint32_t> in_flight;  ///< The active Callbacks of every
+                                    ///< transition
+  std::vector<uint32_t> reserved;   ///< The tokens that active transitions
+                                    ///< will produce, by place
+  std::vector<size_t> throttled;    ///< Enabled transitions that lack room
+  std::vector<uint8_t> is_throttled;  ///< 1 if a transition is in throttled
+  std::vector<size_t> held_inputs;  ///< Input transitions fired by their
+                                    ///< handle that lack room, in order
+  bool has_room;  ///< Set when a completion or a consumption made room
+  WaitPolicy wait_policy;  ///< How the loop waits for events
+  std::vector<Reducer> reducer_buffer;  ///< Reused for bulk dequeueing
+  BatchStatistics batch_statistics;     ///< The sizes of the applied batches
+  std::vector<std::unique_ptr<FiringLatencies>>
+      latencies;  ///< The latencies of the dispatched firings, indexed like
+                  ///< `transition`. Empty until the first one, and null for
+                  ///< transitions that did not fire yet
+  std::shared_ptr<CompletionQueue>
+      completion_queue;  ///< The results of asynchronous Callbacks. Like the
+                         ///< reducer queue, it is captured by the tasks on
+                         ///< the threadpool, which use it after the Petri may
+                         ///< have finished.
+  Continuation continuation;  ///< Receives the result of a suspended run
+  bool is_draining;  ///< Set once a suspended run only awaits its Callbacks
+  std::atomic<Petri*> parent;  ///< The Petri whose loop drives this one, if
+                               ///< it runs as a nested net
+
+  inline static thread_local Petri* driving =
+      nullptr;  ///< The Petri whose event loop runs on this thread, if any
+  inline static thread_local Petri* nesting =
+      nullptr;  ///< Set while a Petri starts a nested net on its loop
 
   /**
-   * @brief Schedules the Callback associated with t on the threadpool
+   * @brief Checks if the calling thread runs the event loop of this Petri, or
+   * of a Petri that drives it as a nested net. Such a thread can not wait for
+   * the loop to answer a query, but it may read the Petri directly.
+   *
+   * @return true if the loop of this Petri runs on the calling thread
+   * @return false otherwise
+   */
+  bool isDrivenHere() const noexcept;
+
+  /**
+   * @brief Prepares a run: it resets the marking, the state and the queued
+   * events, and sets how the loop is woken up when it waits for events.
+   *
+   * @param is_suspended if true, the loop is not run by a thread that blocks
+   * but by drive, which is scheduled whenever an event arrives while the loop
+   * waits: on the loop of the parent if the Petri is nested, and otherwise on
+   * the threadpool.
+   */
+  void start(bool is_suspended);
+
+  /**
+   * @brief Runs the event loop of a suspended run until it has to wait for
+   * events, and then returns. If the run is done, it passes the result to the
+   * Continuation instead. Only one thread drives a Petri at a time.
+   *
+   */
+  void drive();
+
+  /**
+   * @brief Queues a Reducer and wakes up the loop if it waits for events. It
+   * may be called from any thread.
+   *
+   * @param reducer
+   */
+  void post(Reducer&& reducer);
+
+  /**
+   * @brief Applies a Completion: it logs the start, if the Callback started,
+   * and the result of the transition, records its latencies if it was
+   * dispatched and produces its output tokens, unless the transition is no
+   * longer active.
+   *
+   * @param completion
+   * @param applied when the loop applies it, which ends its delivery
+   */
+  void complete(const Completion& completion, Clock::time_point applied);
+
+  /**
+   * @brief Applies a batch of at most `max_batch_size` queued Completions and
+   * Reducers. If there are none, it first waits until there are or the timeout
+   * expires, polling as set by `wait_policy` before it blocks. Reducers are
+   * taken first, so a steady stream of Completions can not hold up e.g. a
+   * cancel. The size of the batch is added to `batch_statistics`.
+   *
+   * @param timeout_usecs the timeout in microseconds, -1 waits indefinitely
+   * @return size_t the amount of Completions and Reducers applied
+   */
+  size_t processEvents(int64_t timeout_usecs);
+
+  /**
+   * @brief Drops all queued Completions and Reducers.
+   *
+   */
+  void discardEvents();
+
+  /**
+   * @brief Adds an instance of t to the active set and schedules its Callback
+   * on the threadpool. If t has a delay, it is scheduled once the delay
+   * expired.
    *
    * @param t transition as index in transition vector
    */
   void fireAsynchronous(const size_t t);
 
+  /**
+   * @brief Fires an input transition through its handle. Like any other
+   * transition it respects its max-in-flight limit and the capacities of its
+   * output places; without room it is held until a completion makes room.
+   *
+   * @param t transition as index in transition vector
+   */
+  void fireInput(const size_t t);
+
+  /**
+   * @brief Fires an instance of which the delay expired: its Callback is
+   * executed immediately if it is synchronous, and scheduled otherwise. If the
+   * run is cancelled in the meantime, the instance completes as Canceled.
+   *
+   * @param instance the delayed instance
+   */
+  void expire(ActiveSet::Id instance);
+
+  /**
+   * @brief Ends an instance of which the Callback did not complete before its
+   * deadline: the Callback is cancelled, and the instance produces TimedOut
+   * tokens and logs TimedOut.
+   *
+   * @param instance the instance that timed out
+   */
+  void timeout(ActiveSet::Id instance);
+
  private:
+  /**
+   * @brief Starts the Callback associated with t: on the loop if it is a
+   * nested net, and on the threadpool otherwise.
+   *
+   * @param t transition as index in transition vector
+   * @param instance the instance that completes with the result
+   */
+  void dispatch(const size_t t, ActiveSet::Id instance);
+
+  /**
+   * @brief Derives the bounds of the run from the limits and capacities, and
+   * clears the bookkeeping of the previous run.
+   *
+   */
+  void resetBounds();
+
+  /**
+   * @brief Checks if t stays within its max-in-flight limit and within the
+   * capacities of its output places if it fires. The tokens that active
+   * transitions will produce count as if they are already there.
+   *
+   * @param t transition as index in transition vector
+   * @return true if t may fire
+   * @return false if t has to wait for room
+   */
+  bool fitsBounds(const size_t t) const noexcept;
+
+  /**
+   * @brief Books a transition that fires: if it is asynchronous, it is in
+   * flight and its output tokens are reserved until it completes.
+   *
+   * @param t transition as index in transition vector
+   * @param is_synchronous
+   */
+  void admit(const size_t t, bool is_synchronous) noexcept;
+
+  /**
+   * @brief Releases the booking of an asynchronous transition that ends.
+   *
+   * @param t transition as index in transition vector
+   */
+  void release(const size_t t) noexcept;
+
+  /**
+   * @brief Queues the throttled transitions again and fires the held input
+   * transitions that fit, once there may be room.
+   *
+   */
+  void retryThrottled();
+
+  /**
+   * @brief Starts the timer of the deadline of an instance of t, if t has a
+   * timeout.
+   *
+   * @param t transition as index in transition vector
+   * @param instance the instance that times out
+   * @return std::shared_ptr<Deadline> the Deadline to claim once the Callback
+   * completes, or nullptr if t has no timeout
+   */
+  std::shared_ptr<Deadline> arm(const size_t t, ActiveSet::Id instance);
+
+  /**
+   * @brief Applies queued Reducers and Completions without waiting.
+   *
+   * @param budget the most Reducers and Completions to dequeue
+   * @return size_t the amount of Completions and Reducers applied
+   */
+  size_t applyEvents(size_t budget);
+
+  /**
+   * @brief Announces that a suspended run waits for events.
+   *
+   * @return true if the loop has to stop; a producer will drive it again
+   * @return false if there are events, and the loop has to continue
+   */
+  bool park();
+
+  /**
+   * @brief Ends a suspended run, and passes its result to the Continuation.
+   * The Petri may not be used afterwards, as it may be destroyed or fired
+   * again.
+   *
+   */
+  void finish();
+
   /**
    * @brief Runs the Callback associated with t immediately.
    *
@@ -288,6 +723,25 @@ std::vector<SmallVector> createReversePlaceToTransitionLookup(
     size_t place_count, size_t transition_count,
     const std::vector<SmallVectorInput>& input_transitions);
 
+/**
+ * @brief Creates the arc table of the inputs or outputs of every transition.
+ *
+ * @param io_n the inputs or outputs of every transition
+ * @return ArcTable
+ */
+ArcTable createArcTable(const std::vector<SmallVectorInput>& io_n);
+
+/**
+ * @brief Creates the table of the transitions that consume from every place. A
+ * transition is listed once per place, even if it has multiple arcs from it.
+ *
+ * @param place_count
+ * @param input_n the inputs of every transition, sorted
+ * @return CsrTable<uint32_t>
+ */
+CsrTable<uint32_t> createReversePlaceToTransitionLookup(
+    size_t place_count, const ArcTable& input_n);
+
 std::vector<int8_t> createPriorityLookup(
     const std::vector<Transition> transition, const PriorityTable& _priority);
 }  // namespace symmetri
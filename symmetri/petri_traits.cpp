@@ -5,15 +5,16 @@
 #include <memory>
 #include <optional>
 #include <thread>
+#include <utility>
 #include <vector>
 
+#include "affinity.h"
 #include "externals/blockingconcurrentqueue.h"
 #include "petri.h"
 #include "symmetri/callback.h"
 #include "symmetri/colors.hpp"
 #include "symmetri/symmetri.h"
 #include "symmetri/types.h"
-#include "symmetri/utilities.hpp"
 
 namespace symmetri {
 
@@ -35,22 +36,13 @@ Token fire(const PetriNet &app) {
   }
   auto &m = *app.impl;
   m.thread_id_.store(getThreadId());
-  m.scheduled_callbacks.clear();
-  m.tokens = m.net.initial_tokens;
-  m.state = Started;
-  Reducer f;
-  while (m.reducer_queue->try_dequeue(f)) { /* get rid of old reducers  */
-  }
-
-  // start!
-  m.reducer_queue->enqueue([=](Petri &) {});
-  while ((m.state == Started || m.state == Paused) &&
-         m.reducer_queue->wait_dequeue_timed(f, -1)) {
-    do {
-      f(m);
-    } while (m.reducer_queue->try_dequeue(f));
+  // the event loop runs on the CPUs reserved for it, if any, until it is done.
+  const ScopedAffinity isolation(m.pool->getLoopCpus());
+  const auto outer = std::exchange(Petri::driving, &m);
+  m.start(false);
 
-    if (MarkingReached(m.tokens, m.final_marking)) {
+  while (m.state == Started || m.state == Paused) {
+    if (m.tokens.goalReached()) {
       m.state = Success;
     }
 
@@ -58,63 +50,99 @@ Token fire(const PetriNet &app) {
       // we're firing
       m.fireTransitions();
       // if there's nothing to fire; we deadlocked
-      if (MarkingReached(m.tokens, m.final_marking)) {
+      if (m.tokens.goalReached()) {
         m.state = Success;
       } else if (m.scheduled_callbacks.size() == 0) {
         m.state = Deadlocked;
       }
     }
+
+    if (m.state == Started || m.state == Paused) {
+      m.processEvents(-1);
+    }
   }
 
-  if (MarkingReached(m.tokens, m.final_marking)) {
+  if (m.tokens.goalReached()) {
     m.state = Success;
   }
 
   while (!m.scheduled_callbacks.empty()) {
-    if (m.reducer_queue->wait_dequeue_timed(f, std::chrono::milliseconds(10))) {
-      f(m);
-    }
+    m.processEvents(10000);
   }
 
+  Petri::driving = outer;
   m.thread_id_.store(std::nullopt);
 
   return m.state;
 }
 
+void fire(const PetriNet &app, Continuation continuation) {
+  // a net that is started by the loop of its parent is nested.
+  const auto parent = std::exchange(Petri::nesting, nullptr);
+  if (app.impl->thread_id_.load().has_value()) {
+    continuation(Failed);
+    return;
+  }
+  auto &m = *app.impl;
+  m.thread_id_.store(getThreadId());
+  m.parent.store(parent);
+  m.continuation = std::move(continuation);
+  m.start(true);
+  m.drive();
+}
+
+bool isNested(const PetriNet &) { return true; }
+
 void cancel(const PetriNet &app) {
-  app.impl->reducer_queue->enqueue([=](Petri &model) {
+  app.impl->post([=](Petri &model) {
     model.state = Canceled;
-    for (const auto transition_index : model.scheduled_callbacks) {
-      cancel(model.net.store.at(transition_index));
-      model.log.push_back({transition_index, Cancel, Clock::now()});
+    for (const auto &instance : model.scheduled_callbacks) {
+      cancel(model.net.store.at(instance.transition));
+      model.log.push_back(
+          {instance.transition, Cancel, Clock::now(), instance.id});
+    }
+    // instances that still wait for their delay are not fired at all.
+    std::vector<ActiveSet::Id> delayed;
+    for (const auto &instance : model.scheduled_callbacks) {
+      if (instance.is_delayed &&
+          model.pool->cancelTimer(instance.delay_timer)) {
+        delayed.push_back(instance.id);
+      }
+    }
+    for (const auto id : delayed) {
+      const auto now = Clock::now();
+      const auto t_i = model.scheduled_callbacks.find(id)->transition;
+      model.complete(
+          {static_cast<uint32_t>(t_i), Canceled, now, now, id, false, false},
+          now);
     }
   });
 }
 
 void pause(const PetriNet &app) {
-  app.impl->reducer_queue->enqueue([](Petri &model) {
+  app.impl->post([](Petri &model) {
     model.state = Paused;
-    for (const auto transition_index : model.scheduled_callbacks) {
-      pause(model.net.store.at(transition_index));
+    for (const auto &instance : model.scheduled_callbacks) {
+      pause(model.net.store.at(instance.transition));
     }
   });
 }
 
 void resume(const PetriNet &app) {
-  app.impl->reducer_queue->enqueue([](Petri &model) {
+  app.impl->post([](Petri &model) {
     model.state = Started;
-    for (const auto transition_index : model.scheduled_callbacks) {
-      resume(model.net.store.at(transition_index));
+    for (const auto &instance : model.scheduled_callbacks) {
+      resume(model.net.store.at(instance.transition));
     }
   });
 }
 
 Eventlog getLog(const PetriNet &app) {
-  if (app.impl->thread_id_.load()) {
+  // the loop of a nested net may run on this thread, and can then not answer.
+  if (app.impl->thread_id_.load() && !app.impl->isDrivenHere()) {
     std::promise<Eventlog> el;
     std::future<Eventlog> el_getter = el.get_future();
-    app.impl->reducer_queue->enqueue(
-        [&](Petri &model) { el.set_value(model.getLogInternal()); });
+    app.impl->post([&](Petri &model) { el.set_value(model.getLogInternal()); });
     return el_getter.get();
   } else {
     return app.impl->getLogInternal();
@@ -4,9 +4,12 @@
 #include <algorithm>
 #include <iterator>
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
+#include "bits.h"
 #include "externals/small_vector.hpp"
 #include "petri.h"
 
@@ -17,6 +20,16 @@ size_t toIndex(const std::vector<std::string> &m, const std::string &s) {
   return std::distance(m.begin(), ptr);
 }
 
+std::unordered_map<std::string_view, size_t> createIndexLookup(
+    const std::vector<std::string> &names) {
+  std::unordered_map<std::string_view, size_t> lookup;
+  lookup.reserve(names.size());
+  for (size_t i = 0; i < names.size(); i++) {
+    lookup.emplace(names[i], i);
+  }
+  return lookup;
+}
+
 bool canFire(const SmallVectorInput &pre,
              const std::vector<AugmentedToken> &tokens) {
   for (const auto &m_p : pre) {
@@ -42,34 +55,41 @@ bool canFire(const SmallVectorInput &pre,
   return not pre.empty();
 }
 
-gch::small_vector<size_t, 32> possibleTransitions(
-    const std::vector<AugmentedToken> &tokens,
-    const std::vector<SmallVectorInput> &input_n,
-    const std::vector<SmallVector> &p_to_ts_n) {
-  gch::small_vector<size_t, 32> possible_transition_list_n;
-  for (const AugmentedToken &place : tokens) {
-    // transition index
-    for (const size_t &t : p_to_ts_n[std::get<size_t>(place)]) {
-      // transition is not already considered:
-      const bool is_unique = std::find(possible_transition_list_n.cbegin(),
-                                       possible_transition_list_n.cend(),
-                                       t) == possible_transition_list_n.cend();
-      if (not is_unique) {
-        continue;  // already in the list, so skip
-      }
-      const auto &inputs = input_n[t];
-      const bool is_input =
-          std::find(inputs.cbegin(), inputs.cend(), place) != inputs.cend();
-      if (not is_input) {
-        continue;  // place is not an input of transition t, so skip
-      }
+void deductMarking(std::vector<AugmentedToken> &tokens,
+                   const SmallVectorInput &inputs) {
+  for (const auto &place : inputs) {
+    tokens.erase(std::find(tokens.begin(), tokens.end(), place));
+  }
+}
 
-      // current colored place is an input of t
-      possible_transition_list_n.push_back(t);
+void possibleTransitions(const DenseMarking &tokens, const ArcTable &input_n,
+                         const CsrTable<uint32_t> &p_to_ts_n,
+                         const std::vector<int8_t> &priority,
+                         const EnablingEngine &engine, ReadyQueue &ready) {
+  const auto &dirty_places = tokens.dirtyPlaces();
+  if (engine.hasBulk() && 8 * dirty_places.size() >= tokens.placeCount()) {
+    // a broad change (e.g. a new initial marking); evaluate all transitions.
+    // The engine is shared between nets, so the scratch space is per thread.
+    static thread_local std::vector<uint64_t> enabled;
+    engine.enabledTransitions(tokens, enabled);
+    for (size_t w = 0; w < enabled.size(); w++) {
+      for (auto bits = enabled[w]; bits != 0; bits &= bits - 1) {
+        const size_t t = w * 64 + lowestBit(bits);
+        ready.push(t, priority[t]);
+      }
     }
+    return;
   }
 
-  return possible_transition_list_n;
+  for (const size_t place : dirty_places) {
+    // transition index
+    for (const size_t t : p_to_ts_n[place]) {
+      // the ReadyQueue ignores transitions that are already queued.
+      if (engine.canFire(t, input_n[t], tokens)) {
+        ready.push(t, priority[t]);
+      }
+    }
+  }
 }
 
 }  // namespace symmetri
@@ -1,5 +1,7 @@
 #include <stddef.h>
+#include <stdint.h>
 
+#include <limits>
 #include <set>
 #include <stdexcept>
 #include <string>
@@ -17,10 +19,45 @@ using namespace tinyxml2;
 
 namespace symmetri {
 
-std::tuple<Net, Marking> readPnml(const std::set<std::string>& files) {
+namespace {
+
+/**
+ * @brief Converts the text of a bound to a number. It throws if the text is
+ * missing, or is not a whole number that fits in 32 bits.
+ *
+ */
+uint32_t toBound(const char* text, const std::string& what) {
+  const std::string value = text == nullptr ? "" : text;
+  if (value.empty() ||
+      value.find_first_not_of("0123456789") != std::string::npos ||
+      value.size() > 10 ||
+      std::stoull(value) > std::numeric_limits<uint32_t>::max()) {
+    throw std::runtime_error("error: " + what +
+                             " is not a number from 0 to 4294967295: \"" +
+                             value + "\".");
+  }
+  return static_cast<uint32_t>(std::stoull(value));
+}
+
+void readBound(XMLElement* node, const char* name, BoundTable& table) {
+  const auto bound = node->FirstChildElement(name);
+  if (bound != nullptr) {
+    const std::string id = node->Attribute("id");
+    const auto text = bound->FirstChildElement("text");
+    table.push_back(
+        {id, toBound(text == nullptr ? nullptr : text->GetText(),
+                     std::string("the ") + name + " of " + id)});
+  }
+}
+
+}  // namespace
+
+std::tuple<Net, Marking, BoundTable, BoundTable> readPnmlWithBounds(
+    const std::set<std::string>& files) {
   std::set<std::string> places, transitions;
   Marking place_initialMarking;
   Net state_net;
+  BoundTable max_in_flight, capacities;
 
   for (auto file : files) {
     XMLDocument net;
@@ -41,6 +78,7 @@ std::tuple<Net, Marking> readPnml(const std::set<std::string>& files) {
         place_initialMarking.push_back(
             {place_id, color == nullptr ? Success : Token(color)});
       }
+      readBound(child, "capacity", capacities);
       places.insert(std::string(place_id));
     }
 
@@ -48,6 +86,7 @@ std::tuple<Net, Marking> readPnml(const std::set<std::string>& files) {
     for (XMLElement* child = levelElement->FirstChildElement("transition");
          child != NULL; child = child->NextSiblingElement("transition")) {
       auto transition_id = child->Attribute("id");
+      readBound(child, "maxInFlight", max_in_flight);
       transitions.insert(transition_id);
     }
 
@@ -96,6 +135,12 @@ std::tuple<Net, Marking> readPnml(const std::set<std::string>& files) {
     }
   }
 
-  return {state_net, place_initialMarking};
+  return {state_net, place_initialMarking, max_in_flight, capacities};
+}
+
+std::tuple<Net, Marking> readPnml(const std::set<std::string>& files) {
+  auto [net, m0, max_in_flight, capacities] = readPnmlWithBounds(files);
+  return {std::move(net), std::move(m0)};
 }
+
 }  // namespace symmetri
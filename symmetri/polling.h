@@ -0,0 +1,52 @@
+#pragma once
+
+/** @file polling.h */
+
+#include <stddef.h>
+
+#include <thread>
+
+#include "symmetri/tasks.h"
+
+namespace symmetri {
+
+/**
+ * @brief Tells the CPU that the thread is in a busy loop, which saves power
+ * and frees resources for a sibling hyperthread.
+ *
+ */
+inline void cpuRelax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * @brief Calls `try_get` until it succeeds or the spins and yields of `policy`
+ * are spent. The caller parks if it does not succeed.
+ *
+ * @param policy
+ * @param try_get returns true once there is work
+ * @return true if `try_get` succeeded
+ * @return false if the budget is spent
+ */
+template <typename F>
+bool poll(const WaitPolicy& policy, F&& try_get) {
+  for (size_t i = 0; i < policy.spins; i++) {
+    if (try_get()) {
+      return true;
+    }
+    cpuRelax();
+  }
+  for (size_t i = 0; i < policy.yields; i++) {
+    if (try_get()) {
+      return true;
+    }
+    std::this_thread::yield();
+  }
+  return false;
+}
+
+}  // namespace symmetri
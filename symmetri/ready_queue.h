@@ -0,0 +1,113 @@
+#pragma once
+
+/** @file ready_queue.h */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <vector>
+
+#include "bits.h"
+
+namespace symmetri {
+
+/**
+ * @brief ReadyQueue holds the transitions that are candidates for firing,
+ * ordered by priority. It has a bucket for each of the 256 possible int8_t
+ * priorities and a bitmap of the non-empty buckets, so inserting and finding
+ * the highest priority transition are O(1). A second bitmap, indexed by
+ * transition, makes sure a transition is queued at most once. Transitions with
+ * the same priority are handled last-in first-out.
+ *
+ */
+class ReadyQueue {
+ public:
+  /**
+   * @brief Construct a new ReadyQueue for a net with `transition_count`
+   * transitions.
+   *
+   * @param transition_count
+   */
+  explicit ReadyQueue(size_t transition_count = 0)
+      : non_empty_{}, queued_((transition_count + 63) / 64, 0) {}
+
+  /**
+   * @brief Queues transition `t` with priority `priority`, unless it is already
+   * queued.
+   *
+   * @param t transition as index in transition vector
+   * @param priority the priority of t
+   */
+  void push(size_t t, int8_t priority) {
+    auto& word = queued_[t / 64];
+    const uint64_t bit = uint64_t{1} << (t % 64);
+    if ((word & bit) == 0) {
+      word |= bit;
+      const auto b = bucketOf(priority);
+      buckets_[b].push_back(t);
+      non_empty_[b / 64] |= uint64_t{1} << (b % 64);
+    }
+  }
+
+  /**
+   * @brief Checks if there are no queued transitions.
+   *
+   * @return true
+   * @return false
+   */
+  bool empty() const noexcept {
+    return (non_empty_[0] | non_empty_[1] | non_empty_[2] | non_empty_[3]) ==
+           0;
+  }
+
+  /**
+   * @brief Get the queued transition with the highest priority. The queue may
+   * not be empty.
+   *
+   * @return size_t
+   */
+  size_t top() const noexcept { return buckets_[highestBucket()].back(); }
+
+  /**
+   * @brief Removes the transition returned by top(). The queue may not be
+   * empty.
+   *
+   */
+  void pop() noexcept {
+    const auto b = highestBucket();
+    auto& bucket = buckets_[b];
+    const auto t = bucket.back();
+    bucket.pop_back();
+    queued_[t / 64] &= ~(uint64_t{1} << (t % 64));
+    if (bucket.empty()) {
+      non_empty_[b / 64] &= ~(uint64_t{1} << (b % 64));
+    }
+  }
+
+ private:
+  /**
+   * @brief maps priority -128 to bucket 0 and priority 127 to bucket 255.
+   *
+   * @param priority
+   * @return size_t
+   */
+  static size_t bucketOf(int8_t priority) noexcept {
+    return static_cast<size_t>(static_cast<int>(priority) + 128);
+  }
+
+  size_t highestBucket() const noexcept {
+    for (size_t w = non_empty_.size(); w-- > 0;) {
+      if (non_empty_[w] != 0) {
+        return w * 64 + highestBit(non_empty_[w]);
+      }
+    }
+    return 0;
+  }
+
+  std::array<std::vector<size_t>, 256> buckets_;  ///< Transitions by priority
+  std::array<uint64_t, 4> non_empty_;  ///< Bitmap of the non-empty buckets
+  std::vector<uint64_t> queued_;       ///< Bitmap of the queued transitions
+};
+
+}  // namespace symmetri
@@ -0,0 +1,60 @@
+#pragma once
+
+/** @file ring.h */
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace symmetri {
+
+/**
+ * @brief Ring is a growable ring that is used as a deque. Unlike std::deque it
+ * keeps its memory when it runs empty, so once it has grown to the largest
+ * amount of queued elements, pushing and popping never allocates.
+ *
+ * @tparam T the type of the elements
+ */
+template <typename T>
+class Ring {
+ public:
+  bool empty() const noexcept { return head_ == tail_; }
+
+  void pushBack(T&& element) {
+    if (tail_ - head_ == elements_.size()) {
+      grow();
+    }
+    elements_[tail_++ & (elements_.size() - 1)] = std::move(element);
+  }
+
+  const T& front() const noexcept {
+    return elements_[head_ & (elements_.size() - 1)];
+  }
+
+  T popBack() noexcept {
+    return std::move(elements_[--tail_ & (elements_.size() - 1)]);
+  }
+
+  T popFront() noexcept {
+    return std::move(elements_[head_++ & (elements_.size() - 1)]);
+  }
+
+ private:
+  void grow() {
+    std::vector<T> larger(std::max<size_t>(16, 2 * elements_.size()));
+    for (auto i = head_; i != tail_; i++) {
+      larger[i - head_] = std::move(elements_[i & (elements_.size() - 1)]);
+    }
+    tail_ -= head_;
+    head_ = 0;
+    elements_.swap(larger);
+  }
+
+  std::vector<T> elements_;  ///< The ring, a power of two in size
+  size_t head_ = 0;          ///< The index of the front
+  size_t tail_ = 0;          ///< The index past the back
+};
+
+}  // namespace symmetri
@@ -0,0 +1,144 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "symmetri/colors.hpp"
+#include "symmetri/parsers.h"
+#include "symmetri/types.h"
+
+namespace symmetri {
+namespace {
+
+std::string quote(std::string_view s) {
+  std::string quoted = "\"";
+  for (const auto c : s) {
+    if (c == '"' || c == '\\') {
+      quoted.push_back('\\');
+    }
+    quoted.push_back(c);
+  }
+  quoted.push_back('"');
+  return quoted;
+}
+
+/**
+ * @brief writes `count` elements as the contents of a std::array, one element
+ * per line.
+ *
+ */
+template <typename F>
+void writeArray(std::ostream& out, size_t count, F&& element) {
+  if (count == 0) {
+    out << "    {},\n";
+    return;
+  }
+  out << "    {{\n";
+  for (size_t i = 0; i < count; i++) {
+    out << "        ";
+    element(i);
+    out << (i + 1 < count ? ",\n" : "\n");
+  }
+  out << "    }},\n";
+}
+
+/**
+ * @brief writes the value of `name` in a table of names and values, or 0 if
+ * the table does not have it.
+ *
+ */
+template <typename Table>
+void writeValue(std::ostream& out, const Table& table,
+                const std::string& name) {
+  const auto it =
+      std::find_if(table.begin(), table.end(),
+                   [&](const auto& entry) { return entry.first == name; });
+  out << (it == table.end() ? 0 : static_cast<int64_t>(it->second));
+}
+
+}  // namespace
+
+std::string writeStaticNet(const Net& net, const Marking& initial_marking,
+                           const PriorityTable& priorities,
+                           const std::string& name,
+                           const BoundTable& max_in_flight,
+                           const BoundTable& capacities) {
+  std::vector<Transition> transitions;
+  std::vector<Place> places;
+  transitions.reserve(net.size());
+  for (const auto& [t, io] : net) {
+    transitions.push_back(t);
+    for (const auto& p : io.first) {
+      places.push_back(p.first);
+    }
+    for (const auto& p : io.second) {
+      places.push_back(p.first);
+    }
+  }
+  for (const auto& p : initial_marking) {
+    places.push_back(p.first);
+  }
+  std::sort(transitions.begin(), transitions.end());
+  std::sort(places.begin(), places.end());
+  places.erase(std::unique(places.begin(), places.end()), places.end());
+
+  std::unordered_map<std::string, size_t> place_index;
+  for (size_t i = 0; i < places.size(); i++) {
+    place_index.emplace(places[i], i);
+  }
+  size_t arc_count = 0;
+  for (const auto& [t, io] : net) {
+    arc_count += io.first.size() + io.second.size();
+  }
+
+  std::ostringstream out;
+  out << "#pragma once\n\n"
+      << "// Generated by symmetri_net_compiler, do not edit.\n\n"
+      << "#include \"symmetri/static_net.hpp\"\n\n"
+      << "namespace symmetri::nets {\n\n"
+      << "inline constexpr StaticNet<" << places.size() << ", "
+      << transitions.size() << ", " << arc_count << ", "
+      << initial_marking.size() << "> " << name << " = {\n";
+
+  writeArray(out, places.size(), [&](size_t i) { out << quote(places[i]); });
+  writeArray(out, transitions.size(),
+             [&](size_t i) { out << quote(transitions[i]); });
+  writeArray(out, transitions.size(), [&](size_t i) {
+    writeValue(out, priorities, transitions[i]);
+  });
+
+  std::vector<std::string> arcs;
+  arcs.reserve(arc_count);
+  for (size_t t = 0; t < transitions.size(); t++) {
+    const auto& [inputs, outputs] = net.at(transitions[t]);
+    for (const auto& arc : {std::make_pair(&inputs, "true"),
+                            std::make_pair(&outputs, "false")}) {
+      for (const auto& [p, c] : *arc.first) {
+        arcs.push_back("{" + std::to_string(t) + ", " +
+                       std::to_string(place_index.at(p)) + ", " +
+                       quote(c.toString()) + ", " + arc.second + "}");
+      }
+    }
+  }
+  writeArray(out, arcs.size(), [&](size_t i) { out << arcs[i]; });
+  writeArray(out, initial_marking.size(), [&](size_t i) {
+    const auto& [p, c] = initial_marking[i];
+    out << "{" << place_index.at(p) << ", " << quote(c.toString()) << "}";
+  });
+  writeArray(out, transitions.size(), [&](size_t i) {
+    writeValue(out, max_in_flight, transitions[i]);
+  });
+  writeArray(out, places.size(), [&](size_t i) {
+    writeValue(out, capacities, places[i]);
+  });
+
+  out << "};\n\n}  // namespace symmetri::nets\n";
+  return out.str();
+}
+
+}  // namespace symmetri
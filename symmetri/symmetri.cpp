@@ -16,25 +16,45 @@
 #include "symmetri/parsers.h"
 
 namespace symmetri {
+namespace {
+
+std::shared_ptr<const CompiledNet> compileFiles(
+    const std::set<std::string>& files, const PriorityTable& priorities) {
+  // get the first file;
+  const std::filesystem::path pn_file = *files.begin();
+  if (pn_file.extension() == ".pnml") {
+    const auto [net, m0, max_in_flight, capacities] = readPnmlWithBounds(files);
+    return std::make_shared<const CompiledNet>(net, priorities, m0,
+                                               max_in_flight, capacities);
+  } else {
+    const auto [net, m0, specific_priorities, max_in_flight, capacities] =
+        readGrmlWithBounds(files);
+    return std::make_shared<const CompiledNet>(net, specific_priorities, m0,
+                                               max_in_flight, capacities);
+  }
+}
+
+}  // namespace
+
+NetTemplate::NetTemplate(const Net& net, const Marking& initial_marking,
+                         const PriorityTable& priorities)
+    : impl(std::make_shared<const CompiledNet>(net, priorities,
+                                               initial_marking)) {}
+
+NetTemplate::NetTemplate(const std::set<std::string>& files,
+                         const PriorityTable& priorities)
+    : impl(compileFiles(files, priorities)) {}
+
+NetTemplate::NetTemplate(const StaticNetView& net)
+    : impl(std::make_shared<const CompiledNet>(net)) {}
 
 PetriNet::PetriNet(const std::set<std::string>& files,
                    const std::string& case_id,
                    std::shared_ptr<TaskSystem> threadpool,
                    const Marking& final_marking,
                    const PriorityTable& priorities)
-    : impl([&] {
-        // get the first file;
-        const std::filesystem::path pn_file = *files.begin();
-        if (pn_file.extension() == ".pnml") {
-          const auto [net, m0] = readPnml(files);
-          return std::make_shared<Petri>(net, priorities, m0, final_marking,
-                                         case_id, threadpool);
-        } else {
-          const auto [net, m0, specific_priorities] = readGrml(files);
-          return std::make_shared<Petri>(net, specific_priorities, m0,
-                                         final_marking, case_id, threadpool);
-        }
-      }()),
+    : impl(std::make_shared<Petri>(compileFiles(files, priorities),
+                                   final_marking, case_id, threadpool)),
       s(impl->net.store) {}
 
 PetriNet::PetriNet(const Net& net, const std::string& case_id,
@@ -45,20 +65,33 @@ PetriNet::PetriNet(const Net& net, const std::string& case_id,
                                    final_marking, case_id, threadpool)),
       s(impl->net.store) {}
 
+PetriNet::PetriNet(const StaticNetView& net, const std::string& case_id,
+                   std::shared_ptr<TaskSystem> threadpool,
+                   const Marking& final_marking)
+    : impl(std::make_shared<Petri>(net, final_marking, case_id, threadpool)),
+      s(impl->net.store) {}
+
+PetriNet::PetriNet(const NetTemplate& net, const std::string& case_id,
+                   std::shared_ptr<TaskSystem> threadpool,
+                   const Marking& final_marking)
+    : impl(std::make_shared<Petri>(net.impl, final_marking, case_id,
+                                   threadpool)),
+      s(impl->net.store) {}
+
 std::function<void()> PetriNet::getInputTransitionHandle(
     const Transition& transition) const noexcept {
-  const auto t_index = toIndex(impl->net.transition, transition);
-  // if the transition has input places, you can not register a callback like
-  // this, we simply return a non-functioning handle.
-  if (!impl->net.input_n[t_index].empty()) {
+  const auto t_index = impl->net.compiled->transitionIndex(transition);
+  // if the transition is unknown or has input places, you can not register a
+  // callback like this, we simply return a non-functioning handle.
+  if (t_index == impl->net.transition.size() ||
+      !impl->net.input_n[t_index].empty()) {
     return []() -> void {
       // adding an error message here might be kind to do
     };
   } else {
     return [t_index, this]() -> void {
       if (impl->thread_id_.load()) {
-        impl->reducer_queue->enqueue(
-            [t_index](Petri& m) { m.fireAsynchronous(t_index); });
+        impl->post([t_index](Petri& m) { m.fireInput(t_index); });
       }
     };
   }
@@ -72,18 +105,15 @@ void PetriNet::registerCallback(const std::string& transition,
 }
 std::vector<Callback>::iterator PetriNet::getCallbackItr(
     const std::string& transition_name) const {
-  const auto& t = impl->net.transition;
   return impl->net.store.begin() +
-         std::distance(t.begin(),
-                       std::find(t.begin(), t.end(), transition_name));
+         impl->net.compiled->transitionIndex(transition_name);
 }
 
 Marking PetriNet::getMarking() const noexcept {
-  if (impl->thread_id_.load()) {
+  if (impl->thread_id_.load() && !impl->isDrivenHere()) {
     std::promise<Marking> el;
     std::future<Marking> el_getter = el.get_future();
-    impl->reducer_queue->enqueue(
-        [&](Petri& model) { el.set_value(model.getMarking()); });
+    impl->post([&](Petri& model) { el.set_value(model.getMarking()); });
     return el_getter.get();
   } else {
     return impl->getMarking();
@@ -91,10 +121,10 @@ Marking PetriNet::getMarking() const noexcept {
 }
 
 std::vector<Transition> PetriNet::getActiveTransitions() const noexcept {
-  if (impl->thread_id_.load()) {
+  if (impl->thread_id_.load() && !impl->isDrivenHere()) {
     std::promise<std::vector<Transition>> el;
     std::future<std::vector<Transition>> el_getter = el.get_future();
-    impl->reducer_queue->enqueue(
+    impl->post(
         [&](Petri& model) { el.set_value(model.getActiveTransitions()); });
     return el_getter.get();
   } else {
@@ -102,6 +132,74 @@ std::vector<Transition> PetriNet::getActiveTransitions() const noexcept {
   }
 }
 
+void PetriNet::setMaxBatchSize(size_t max_batch_size) const noexcept {
+  if (!impl->thread_id_.load().has_value()) {
+    impl->max_batch_size = std::max<size_t>(max_batch_size, 1);
+  }
+}
+
+void PetriNet::setWaitPolicy(WaitPolicy wait_policy) const noexcept {
+  if (!impl->thread_id_.load().has_value()) {
+    impl->wait_policy = wait_policy;
+  }
+}
+
+void PetriNet::setDelay(const std::string& transition,
+                        Clock::duration delay) const noexcept {
+  const auto t_index = impl->net.compiled->transitionIndex(transition);
+  if (!impl->thread_id_.load().has_value() && t_index < impl->delays.size()) {
+    impl->delays[t_index] = std::max(delay, Clock::duration::zero());
+  }
+}
+
+void PetriNet::setTimeout(const std::string& transition,
+                          Clock::duration timeout) const noexcept {
+  const auto t_index = impl->net.compiled->transitionIndex(transition);
+  if (!impl->thread_id_.load().has_value() && t_index < impl->timeouts.size()) {
+    impl->timeouts[t_index] = std::max(timeout, Clock::duration::zero());
+  }
+}
+
+void PetriNet::setMaxInFlight(const std::string& transition,
+                              uint32_t limit) const noexcept {
+  const auto t_index = impl->net.compiled->transitionIndex(transition);
+  if (!impl->thread_id_.load().has_value() &&
+      t_index < impl->max_in_flight.size()) {
+    impl->max_in_flight[t_index] = limit;
+  }
+}
+
+void PetriNet::setCapacity(const std::string& place,
+                           uint32_t capacity) const noexcept {
+  const auto& place_index = impl->net.compiled->place_index;
+  const auto it = place_index.find(place);
+  if (!impl->thread_id_.load().has_value() && it != place_index.end()) {
+    impl->capacity[it->second] = capacity;
+  }
+}
+
+BatchStatistics PetriNet::getBatchStatistics() const noexcept {
+  if (impl->thread_id_.load() && !impl->isDrivenHere()) {
+    std::promise<BatchStatistics> el;
+    std::future<BatchStatistics> el_getter = el.get_future();
+    impl->post([&](Petri& model) { el.set_value(model.batch_statistics); });
+    return el_getter.get();
+  } else {
+    return impl->batch_statistics;
+  }
+}
+
+Latencies PetriNet::getLatencies() const noexcept {
+  if (impl->thread_id_.load() && !impl->isDrivenHere()) {
+    std::promise<Latencies> el;
+    std::future<Latencies> el_getter = el.get_future();
+    impl->post([&](Petri& model) { el.set_value(model.getLatencies()); });
+    return el_getter.get();
+  } else {
+    return impl->getLatencies();
+  }
+}
+
 bool PetriNet::reuseApplication(const std::string& new_case_id) {
   if (!impl->thread_id_.load().has_value() && new_case_id != impl->case_id) {
     impl->case_id = new_case_id;
@@ -1,62 +1,499 @@
 #include "symmetri/tasks.h"
 
+#include <stdint.h>
+
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
 #include <iterator>
+#include <limits>
+#include <mutex>
 #include <utility>
+#include <vector>
 
+#include "affinity.h"
+#include "bits.h"
 #include "externals/blockingconcurrentqueue.h"
+#include "polling.h"
+#include "ring.h"
+#include "timer_wheel.h"
 
 namespace symmetri {
 
 /**
- * @brief An alias for the implementation. In this case
+ * @brief TaskQueue distributes the tasks of a TaskSystem over its workers.
+ *
+ */
+class TaskQueue {
+ public:
+  virtual ~TaskQueue() = default;
+
+  /**
+   * @brief Queues a task. It may be called from any thread.
+   *
+   * @param task
+   * @param priority only used by queues that schedule by priority
+   */
+  virtual void push(TaskSystem::Task&& task, int8_t priority) = 0;
+
+  /**
+   * @brief Takes a task for a worker, and waits as set by `wait_policy` if
+   * there is none.
+   *
+   * @param worker the index of the calling worker
+   * @param wait_policy
+   * @return TaskSystem::Task
+   */
+  virtual TaskSystem::Task pop(size_t worker,
+                               const WaitPolicy& wait_policy) = 0;
+};
+
+/**
+ * @brief TimerThread pushes the delayed tasks of a TaskSystem to its queue once
+ * their delay expires. The tasks wait in a TimerWheel, which counts ticks of
+ * `resolution` since `epoch`. The thread sleeps until the next tick at which
+ * the wheel has work, and is woken up early only if a task is added with an
+ * earlier deadline.
+ *
+ */
+class TimerThread {
+ public:
+  TimerThread(TaskQueue& queue, std::chrono::steady_clock::duration resolution,
+              std::string name)
+      : queue_(queue),
+        resolution_(
+            std::max(resolution, std::chrono::steady_clock::duration(1))),
+        name_(std::move(name)),
+        epoch_(std::chrono::steady_clock::now()),
+        is_stopping_(false) {}
+
+  ~TimerThread() noexcept {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      is_stopping_ = true;
+    }
+    wake_.notify_one();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  TaskSystem::TimerId add(std::chrono::steady_clock::duration delay,
+                          TaskSystem::Task&& task, bool is_inline) {
+    // the deadline is rounded up, so a task is never pushed early.
+    const auto elapsed = std::chrono::steady_clock::now() + delay - epoch_;
+    const auto deadline =
+        elapsed.count() <= 0
+            ? uint64_t(0)
+            : static_cast<uint64_t>((elapsed + resolution_ -
+                                     std::chrono::steady_clock::duration(1)) /
+                                    resolution_);
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!thread_.joinable()) {
+      thread_ = std::thread(&TimerThread::loop, this);
+    }
+    const auto next = nextTick();
+    const auto id = is_inline ? wheel_inline_.add(deadline, std::move(task)) |
+                                    inline_bit
+                              : wheel_.add(deadline, std::move(task));
+    const bool is_earlier = nextTick() < next;
+    lock.unlock();
+    if (is_earlier) {
+      wake_.notify_one();
+    }
+    return id;
+  }
+
+  bool cancel(TaskSystem::TimerId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return (id & inline_bit) != 0 ? wheel_inline_.cancel(id & ~inline_bit)
+                                  : wheel_.cancel(id);
+  }
+
+ private:
+  // node indices of a wheel stay far below 2^31, so the top bit of the index
+  // tells the wheels apart.
+  static constexpr TaskSystem::TimerId inline_bit = uint64_t(1) << 31;
+
+  uint64_t nextTick() const noexcept {
+    return std::min(wheel_.nextTick(), wheel_inline_.nextTick());
+  }
+
+  void loop() {
+    setCurrentThreadName(name_ + "-timer");
+    std::vector<TaskSystem::Task> expired;
+    std::vector<TaskSystem::Task> expired_inline;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!is_stopping_) {
+      const auto now = static_cast<uint64_t>(
+          (std::chrono::steady_clock::now() - epoch_) / resolution_);
+      wheel_.advance(now, expired);
+      wheel_inline_.advance(now, expired_inline);
+      if (!expired.empty() || !expired_inline.empty()) {
+        lock.unlock();
+        for (auto& task : expired_inline) {
+          task();
+        }
+        expired_inline.clear();
+        for (auto& task : expired) {
+          queue_.push(std::move(task), 0);
+        }
+        expired.clear();
+        lock.lock();
+        continue;
+      }
+      const auto next = nextTick();
+      if (next == std::numeric_limits<uint64_t>::max()) {
+        wake_.wait(lock);
+      } else {
+        wake_.wait_until(lock, epoch_ + next * resolution_);
+      }
+    }
+  }
+
+  TaskQueue& queue_;                                      ///< Gets due tasks
+  const std::chrono::steady_clock::duration resolution_;  ///< The tick
+  const std::string name_;                             ///< The thread prefix
+  const std::chrono::steady_clock::time_point epoch_;  ///< The tick 0
+  std::mutex mutex_;              ///< Guards the wheel and is_stopping_
+  std::condition_variable wake_;  ///< Wakes the thread early
+  TimerWheel wheel_;              ///< The tasks that go to the queue
+  TimerWheel wheel_inline_;       ///< The tasks that run on the thread
+  bool is_stopping_;              ///< Set when the TaskSystem is destroyed
+  std::thread thread_;            ///< Started by the first delayed task
+};
+
+namespace {
+
+/**
+ * @brief SharedQueue is a TaskQueue in which all workers take tasks from one
  * moodycamel::BlockingConcurrentQueue.
  *
  */
-using Queue = moodycamel::BlockingConcurrentQueue<TaskSystem::Task>;
+class SharedQueue final : public TaskQueue {
+ public:
+  SharedQueue() : queue_(256) {}
+
+  void push(TaskSystem::Task&& task, int8_t) override {
+    queue_.enqueue(std::move(task));
+  }
+
+  TaskSystem::Task pop(size_t, const WaitPolicy& wait_policy) override {
+    TaskSystem::Task task;
+    if (!poll(wait_policy, [&] { return queue_.try_dequeue(task); })) {
+      queue_.wait_dequeue(task);
+    }
+    return task;
+  }
+
+ private:
+  moodycamel::BlockingConcurrentQueue<TaskSystem::Task> queue_;
+};
+
+/**
+ * @brief WorkStealingQueue is a TaskQueue in which every worker has a deque.
+ * Workers push to and pop from the back of their own deque, so nested tasks
+ * run while their data is still in the cache. Other threads push to a shared
+ * injection queue. A worker with an empty deque takes from the injection
+ * queue, or steals from the front of the deque of a random other worker.
+ *
+ * A semaphore counts the queued tasks. A worker first takes a unit from it,
+ * which guarantees there is a task for it somewhere, and then looks for that
+ * task. This way idle workers can park without missing a push.
+ *
+ */
+class WorkStealingQueue final : public TaskQueue {
+ public:
+  explicit WorkStealingQueue(size_t worker_count) : workers_(worker_count) {
+    for (size_t i = 0; i < worker_count; i++) {
+      workers_[i].rng = static_cast<uint32_t>(i * 2654435761u) | 1;
+    }
+  }
+
+  void push(TaskSystem::Task&& task, int8_t) override {
+    if (current_queue_ == this) {
+      auto& self = workers_[current_worker_];
+      std::lock_guard<std::mutex> lock(self.mutex);
+      self.tasks.pushBack(std::move(task));
+    } else {
+      injection_.enqueue(std::move(task));
+    }
+    available_.signal();
+  }
+
+  TaskSystem::Task pop(size_t worker, const WaitPolicy& wait_policy) override {
+    current_queue_ = this;
+    current_worker_ = worker;
+    if (!poll(wait_policy, [this] { return available_.tryWait(); })) {
+      available_.wait();
+    }
+
+    auto& self = workers_[worker];
+    TaskSystem::Task task;
+    while (true) {
+      // now and then the injection queue goes first, so that a worker that
+      // keeps pushing to its own deque does not starve it.
+      if (++self.ticks % 61 == 0 && injection_.try_dequeue(task)) {
+        return task;
+      }
+      if (popOwn(self, task) || injection_.try_dequeue(task) ||
+          steal(worker, task)) {
+        return task;
+      }
+      // the task is being pushed or its deque is locked by another thief.
+      cpuRelax();
+    }
+  }
+
+ private:
+  struct alignas(64) Worker {
+    std::mutex mutex;              ///< Guards tasks
+    Ring<TaskSystem::Task> tasks;  ///< The deque of the worker
+    uint32_t rng;                  ///< State to pick victims with
+    size_t ticks = 0;              ///< The amount of pops
+  };
+
+  static bool popOwn(Worker& self, TaskSystem::Task& task) {
+    std::lock_guard<std::mutex> lock(self.mutex);
+    if (self.tasks.empty()) {
+      return false;
+    }
+    task = self.tasks.popBack();
+    return true;
+  }
+
+  bool steal(size_t worker, TaskSystem::Task& task) {
+    auto& rng = workers_[worker].rng;
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    const auto first = rng % workers_.size();
+    for (size_t i = 0; i < workers_.size(); i++) {
+      const auto victim = (first + i) % workers_.size();
+      if (victim == worker) {
+        continue;
+      }
+      auto& other = workers_[victim];
+      std::unique_lock<std::mutex> lock(other.mutex, std::try_to_lock);
+      if (lock.owns_lock() && !other.tasks.empty()) {
+        task = other.tasks.popFront();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::vector<Worker> workers_;  ///< The deques, by worker
+  moodycamel::ConcurrentQueue<TaskSystem::Task>
+      injection_;                              ///< Tasks from other threads
+  moodycamel::LightweightSemaphore available_;  ///< The amount of tasks
+
+  inline static thread_local const WorkStealingQueue* current_queue_ =
+      nullptr;  ///< The queue of the worker on this thread, if any
+  inline static thread_local size_t current_worker_ =
+      0;  ///< The index of the worker on this thread
+};
 
 /**
- * @brief TaskQueue is an inheritance based alias for a lock-free queue.
+ * @brief PriorityQueue is a TaskQueue with a FIFO level per priority. Workers
+ * take the task with the highest effective priority, which is its priority
+ * plus one level for every `aging` it has been queued. The oldest task of a
+ * level is always at its front, so only the fronts of the non-empty levels
+ * are compared. Aging bounds the queueing delay of every task: a task that
+ * waits long enough outranks any task that is pushed later.
  *
  */
-class TaskQueue : public Queue {
-  using Queue::Queue;
+class PriorityQueue final : public TaskQueue {
+ public:
+  explicit PriorityQueue(std::chrono::steady_clock::duration aging)
+      : aging_(std::max(aging, std::chrono::steady_clock::duration(1))),
+        non_empty_{} {}
+
+  void push(TaskSystem::Task&& task, int8_t priority) override {
+    const size_t level = static_cast<size_t>(static_cast<int>(priority) + 128);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      levels_[level].pushBack(
+          {std::move(task), std::chrono::steady_clock::now()});
+      non_empty_[level / 64] |= uint64_t{1} << (level % 64);
+    }
+    available_.signal();
+  }
+
+  TaskSystem::Task pop(size_t, const WaitPolicy& wait_policy) override {
+    if (!poll(wait_policy, [this] { return available_.tryWait(); })) {
+      available_.wait();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto now = std::chrono::steady_clock::now();
+    size_t best = 0;
+    int64_t best_priority = std::numeric_limits<int64_t>::min();
+    for (size_t w = 0; w < non_empty_.size(); w++) {
+      for (auto bits = non_empty_[w]; bits != 0; bits &= bits - 1) {
+        const size_t level = w * 64 + lowestBit(bits);
+        const auto waited = now - levels_[level].front().queued;
+        const int64_t priority =
+            static_cast<int64_t>(level) + waited / aging_;
+        // levels ascend, so ties go to the higher priority.
+        if (priority >= best_priority) {
+          best = level;
+          best_priority = priority;
+        }
+      }
+    }
+
+    auto task = levels_[best].popFront().task;
+    if (levels_[best].empty()) {
+      non_empty_[best / 64] &= ~(uint64_t{1} << (best % 64));
+    }
+    return task;
+  }
+
+ private:
+  struct Entry {
+    TaskSystem::Task task;                        ///< The queued task
+    std::chrono::steady_clock::time_point queued;  ///< When it was pushed
+  };
+
+  const std::chrono::steady_clock::duration aging_;  ///< The time per level
+  std::mutex mutex_;                                 ///< Guards the levels
+  std::array<Ring<Entry>, 256> levels_;  ///< The tasks, by priority + 128
+  std::array<uint64_t, 4> non_empty_;    ///< A bit per non-empty level
+  moodycamel::LightweightSemaphore available_;  ///< The amount of tasks
 };
 
-TaskSystem::TaskSystem(size_t thread_count)
-    : pool_(thread_count),
+/**
+ * @brief Creates the TaskQueue for the configured scheduling.
+ *
+ * @param config
+ * @return std::unique_ptr<TaskQueue>
+ */
+std::unique_ptr<TaskQueue> makeQueue(const TaskSystemConfig& config) {
+  switch (config.scheduling) {
+    case Scheduling::WorkStealing:
+      return std::make_unique<WorkStealingQueue>(config.thread_count);
+    case Scheduling::Priority:
+      return std::make_unique<PriorityQueue>(config.priority_aging);
+    case Scheduling::SharedQueue:
+    default:
+      return std::make_unique<SharedQueue>();
+  }
+}
+
+/**
+ * @brief Resolves the CPUs of every worker from the configuration.
+ *
+ * @param config
+ * @return std::vector<std::vector<size_t>> the CPUs by worker; empty for a
+ * worker that is not pinned.
+ */
+std::vector<std::vector<size_t>> resolveWorkerCpus(
+    const TaskSystemConfig& config) {
+  std::vector<std::vector<size_t>> cpus(config.thread_count);
+  if (!config.worker_cpus.empty()) {
+    for (size_t i = 0; i < cpus.size(); i++) {
+      cpus[i] = config.worker_cpus[i % config.worker_cpus.size()];
+    }
+    return cpus;
+  }
+
+  std::vector<std::vector<size_t>> node_cpus;
+  for (const auto node : config.numa_nodes) {
+    node_cpus.push_back(numaNodeCpus(node));
+  }
+  const auto online = config.loop_cpus.empty() || !node_cpus.empty()
+                          ? std::vector<size_t>{}
+                          : onlineCpus();
+  for (size_t i = 0; i < cpus.size(); i++) {
+    cpus[i] = node_cpus.empty() ? online : node_cpus[i % node_cpus.size()];
+    // workers stay off the CPUs of the event loops, unless nothing is left.
+    std::vector<size_t> available;
+    std::copy_if(cpus[i].begin(), cpus[i].end(), std::back_inserter(available),
+                 [&config](size_t cpu) {
+                   return std::find(config.loop_cpus.begin(),
+                                    config.loop_cpus.end(),
+                                    cpu) == config.loop_cpus.end();
+                 });
+    if (!available.empty()) {
+      cpus[i] = std::move(available);
+    }
+  }
+  return cpus;
+}
+
+}  // namespace
+
+TaskSystem::TaskSystem(size_t thread_count, WaitPolicy wait_policy,
+                       Scheduling scheduling)
+    : TaskSystem([&] {
+        TaskSystemConfig config;
+        config.thread_count = thread_count;
+        config.wait_policy = wait_policy;
+        config.scheduling = scheduling;
+        return config;
+      }()) {}
+
+TaskSystem::TaskSystem(const TaskSystemConfig& config)
+    : pool_(config.thread_count),
       is_running_(false),
-      queue_(std::make_unique<TaskQueue>(256)) {
-  std::generate(std::begin(pool_), std::end(pool_),
-                [this] { return std::thread(&TaskSystem::loop, this); });
+      queue_(makeQueue(config)),
+      timers_(std::make_unique<TimerThread>(*queue_, config.timer_resolution,
+                                            config.name)),
+      wait_policy_(config.wait_policy),
+      name_(config.name),
+      worker_cpus_(resolveWorkerCpus(config)),
+      loop_cpus_(config.loop_cpus) {
+  for (size_t i = 0; i < pool_.size(); i++) {
+    pool_[i] = std::thread(&TaskSystem::loop, this, i);
+  }
 }
 
 TaskSystem::~TaskSystem() noexcept {
+  // the timer thread pushes to the queue, so it stops first.
+  timers_.reset();
   is_running_.store(true, std::memory_order_release);
   for (size_t i = 0; i < pool_.size(); ++i) {
-    queue_->enqueue([] {});
+    queue_->push([] {}, 0);
   }
-  for (auto &t : pool_) {
+  for (auto& t : pool_) {
     if (t.joinable()) {
       t.join();
     }
   }
 }
 
-void TaskSystem::loop() {
+void TaskSystem::loop(size_t worker) {
+  setCurrentThreadName(name_ + "-" + std::to_string(worker));
+  setCurrentThreadAffinity(worker_cpus_[worker]);
   while (true) {
-    Task transition;
-    if (queue_->wait_dequeue_timed(transition, -1)) {
-      if (is_running_.load(std::memory_order_acquire)) {
-        break;
-      }
-      transition();
+    Task transition = queue_->pop(worker, wait_policy_);
+    if (is_running_.load(std::memory_order_acquire)) {
+      break;
     }
+    transition();
   }
 }
 
-void TaskSystem::push(Task &&p) const {
-  queue_->enqueue(std::forward<Task>(p));
+void TaskSystem::push(Task&& p, int8_t priority) const {
+  queue_->push(std::move(p), priority);
+}
+
+TaskSystem::TimerId TaskSystem::pushAfter(
+    std::chrono::steady_clock::duration delay, Task&& p) const {
+  return timers_->add(delay, std::move(p), false);
+}
+
+TaskSystem::TimerId TaskSystem::callAfter(
+    std::chrono::steady_clock::duration delay, Task&& p) const {
+  return timers_->add(delay, std::move(p), true);
+}
+
+bool TaskSystem::cancelTimer(TimerId id) const { return timers_->cancel(id); }
+
+const std::vector<size_t>& TaskSystem::getLoopCpus() const noexcept {
+  return loop_cpus_;
 }
 
 }  // namespace symmetri
@@ -1,3 +1,9 @@
+#include <chrono>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <vector>
+
 #include "doctest/doctest.h"
 #include "symmetri/tasks.h"
 
@@ -41,3 +47,171 @@ TEST_CASE("Run the executor parallel tasks") {
   CHECK(static_cast<bool>(main_thread != thread_id1));
   CHECK(static_cast<bool>(main_thread != thread_id2));
 }
+
+TEST_CASE("Run the executor with workers that poll before parking") {
+  // the workers yield a bit and then park, so both a task pushed right away
+  // and a task pushed after the workers parked run.
+  auto threadpool = std::make_shared<TaskSystem>(2, WaitPolicy{100, 100});
+  std::atomic<int> ran(0);
+  threadpool->push([&]() { ran++; });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  threadpool->push([&]() { ran++; });
+  while (ran.load() < 2) {
+  }
+  CHECK(ran.load() == 2);
+}
+
+TEST_CASE("Run nested tasks on a work-stealing executor") {
+  auto threadpool = std::make_shared<TaskSystem>(4, WaitPolicy{},
+                                                 Scheduling::WorkStealing);
+  // every task pushes two more from its worker, until the leaves.
+  std::atomic<int> leaves(0);
+  std::function<void(int)> fork = [&](int depth) {
+    if (depth == 0) {
+      leaves++;
+      return;
+    }
+    threadpool->push([&, depth] { fork(depth - 1); });
+    threadpool->push([&, depth] { fork(depth - 1); });
+  };
+  threadpool->push([&] { fork(10); });
+  while (leaves.load() < 1024) {
+    std::this_thread::yield();
+  }
+  CHECK(leaves.load() == 1024);
+}
+
+TEST_CASE("A task owns its captures and releases them once") {
+  auto state = std::make_shared<int>(0);
+  TaskSystem::Task task([state] { (*state)++; });
+  static_assert(!std::is_copy_constructible_v<TaskSystem::Task>);
+  CHECK(state.use_count() == 2);
+
+  // moving hands over the capture; the source becomes empty.
+  TaskSystem::Task moved(std::move(task));
+  CHECK(!task);
+  CHECK(moved);
+  CHECK(state.use_count() == 2);
+  moved();
+  CHECK(*state == 1);
+
+  task = std::move(moved);
+  CHECK(state.use_count() == 2);
+  task = TaskSystem::Task();
+  CHECK(state.use_count() == 1);
+}
+
+TEST_CASE("Run a task that fills the inline storage") {
+  auto threadpool = std::make_shared<TaskSystem>(1);
+  std::atomic<bool> ran(false);
+  std::array<char, TaskSystem::task_capacity - sizeof(void*)> payload = {};
+  payload.back() = 1;
+  threadpool->push([&ran, payload] { ran.store(payload.back() == 1); });
+  while (!ran.load()) {
+  }
+  CHECK(ran);
+}
+
+TEST_CASE("Run high priority tasks first on a priority executor") {
+  TaskSystemConfig config;
+  config.thread_count = 1;
+  config.scheduling = Scheduling::Priority;
+  config.priority_aging = std::chrono::hours(1);
+  auto threadpool = std::make_shared<TaskSystem>(config);
+
+  // keep the only worker busy until all tasks are queued.
+  std::promise<void> queued;
+  threadpool->push([ready = queued.get_future().share()] { ready.wait(); });
+  std::mutex mutex;
+  std::vector<int> order;
+  for (int8_t priority : {-1, 0, 5, 0, 5, -1}) {
+    threadpool->push(
+        [&, priority] {
+          std::lock_guard<std::mutex> lock(mutex);
+          order.push_back(priority);
+        },
+        priority);
+  }
+  queued.set_value();
+  while (true) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (order.size() == 6) {
+      break;
+    }
+  }
+  CHECK(order == std::vector<int>{5, 5, 0, 0, -1, -1});
+}
+
+TEST_CASE("Waiting raises the priority of a task") {
+  TaskSystemConfig config;
+  config.thread_count = 1;
+  config.scheduling = Scheduling::Priority;
+  config.priority_aging = std::chrono::microseconds(10);
+  auto threadpool = std::make_shared<TaskSystem>(config);
+
+  std::promise<void> queued;
+  threadpool->push([ready = queued.get_future().share()] { ready.wait(); });
+  std::mutex mutex;
+  std::vector<int> order;
+  const auto record = [&](int id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    order.push_back(id);
+  };
+  threadpool->push([&] { record(0); }, -128);
+  // 10ms of waiting is worth 1000 levels, more than the whole range.
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  threadpool->push([&] { record(1); }, 127);
+  queued.set_value();
+  while (true) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (order.size() == 2) {
+      break;
+    }
+  }
+  CHECK(order == std::vector<int>{0, 1});
+}
+
+TEST_CASE("Push tasks after a delay, and cancel them before it expires") {
+  auto threadpool = std::make_shared<TaskSystem>(1);
+  std::mutex mutex;
+  std::vector<int> order;
+  std::promise<void> done;
+  const auto begin = std::chrono::steady_clock::now();
+  threadpool->pushAfter(std::chrono::milliseconds(20), [&] {
+    std::lock_guard<std::mutex> lock(mutex);
+    order.push_back(20);
+    done.set_value();
+  });
+  threadpool->pushAfter(std::chrono::milliseconds(5), [&] {
+    std::lock_guard<std::mutex> lock(mutex);
+    order.push_back(5);
+  });
+  const auto cancelled = threadpool->pushAfter(
+      std::chrono::milliseconds(10), [&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back(10);
+      });
+  CHECK(threadpool->cancelTimer(cancelled));
+  done.get_future().wait();
+  CHECK(std::chrono::steady_clock::now() - begin >=
+        std::chrono::milliseconds(20));
+  CHECK(!threadpool->cancelTimer(cancelled));
+  std::lock_guard<std::mutex> lock(mutex);
+  CHECK(order == std::vector<int>{5, 20});
+}
+
+TEST_CASE("Tasks called after a delay run while all workers are busy") {
+  auto threadpool = std::make_shared<TaskSystem>(1);
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  threadpool->push([released] { released.wait(); });
+  std::promise<void> done;
+  const auto cancelled =
+      threadpool->callAfter(std::chrono::milliseconds(5), [] {});
+  CHECK(threadpool->cancelTimer(cancelled));
+  threadpool->callAfter(std::chrono::milliseconds(5),
+                        [&done] { done.set_value(); });
+  CHECK(done.get_future().wait_for(std::chrono::seconds(5)) ==
+        std::future_status::ready);
+  release.set_value();
+}
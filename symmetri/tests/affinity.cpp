@@ -0,0 +1,90 @@
+#include "affinity.h"
+
+#include <atomic>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "symmetri/symmetri.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace symmetri;
+
+TEST_CASE("Parse CPU lists as found in sysfs") {
+  CHECK(parseCpuList("0-3,8,10-11\n") ==
+        std::vector<size_t>{0, 1, 2, 3, 8, 10, 11});
+  CHECK(parseCpuList("5") == std::vector<size_t>{5});
+  CHECK(parseCpuList("") == std::vector<size_t>{});
+  // malformed ranges are skipped.
+  CHECK(parseCpuList("x,3-1,2") == std::vector<size_t>{2});
+}
+
+#if defined(__linux__)
+
+namespace {
+
+std::string currentThreadName() {
+  char name[16] = {};
+  pthread_getname_np(pthread_self(), name, sizeof(name));
+  return name;
+}
+
+size_t allowedCpuCount() {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+  return static_cast<size_t>(CPU_COUNT(&set));
+}
+
+}  // namespace
+
+struct OnLoop {
+  std::vector<size_t>* allowed_cpus;
+};
+
+bool isSynchronous(const OnLoop&) { return true; }
+
+Token fire(const OnLoop& callback) {
+  callback.allowed_cpus->push_back(allowedCpuCount());
+  return Success;
+}
+
+TEST_CASE("Workers are named and pinned as configured") {
+  TaskSystemConfig config;
+  config.thread_count = 2;
+  config.name = "worker";
+  config.worker_cpus = {{0}};
+  auto pool = std::make_shared<TaskSystem>(config);
+
+  std::promise<std::pair<std::string, int>> placement;
+  pool->push([&placement] {
+    placement.set_value({currentThreadName(), sched_getcpu()});
+  });
+  const auto [name, cpu] = placement.get_future().get();
+  CHECK((name == "worker-0" || name == "worker-1"));
+  CHECK(cpu == 0);
+}
+
+TEST_CASE("The event loop runs on the loop CPUs until fire returns") {
+  TaskSystemConfig config;
+  config.thread_count = 1;
+  config.loop_cpus = {0};
+  auto pool = std::make_shared<TaskSystem>(config);
+  Net net = {{"t", {{{"Pa", Success}}, {{"Pb", Success}}}}};
+  PetriNet app(net, "isolated", pool, {{"Pa", Success}}, {{"Pb", Success}});
+  // synchronous callbacks run on the thread of the event loop.
+  std::vector<size_t> allowed_cpus;
+  app.registerCallback("t", OnLoop{&allowed_cpus});
+
+  const auto cpus_before = allowedCpuCount();
+  CHECK(fire(app) == Success);
+  CHECK(allowed_cpus == std::vector<size_t>{1});
+  CHECK(allowedCpuCount() == cpus_before);
+}
+
+#endif
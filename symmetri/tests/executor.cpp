@@ -0,0 +1,88 @@
+#include "symmetri/executor.h"
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "symmetri/symmetri.h"
+
+using namespace symmetri;
+
+TEST_CASE("An Executor runs many nets on a few loops") {
+  auto pool = std::make_shared<TaskSystem>(2);
+  const NetTemplate net({{"t0", {{{"Pa", Success}}, {{"Pb", Success}}}},
+                         {"t1", {{{"Pb", Success}}, {{"Pc", Success}}}}},
+                        {{"Pa", Success}});
+  Executor executor(2);
+
+  std::vector<std::unique_ptr<PetriNet>> nets;
+  std::vector<std::future<Token>> results;
+  for (size_t i = 0; i < 200; i++) {
+    nets.push_back(std::make_unique<PetriNet>(net, "case" + std::to_string(i),
+                                              pool, Marking{{"Pc", Success}}));
+    nets.back()->registerCallback("t0", [] { return Success; });
+    results.push_back(executor.submit(*nets.back()));
+  }
+  for (auto& result : results) {
+    CHECK(result.get() == Success);
+  }
+  CHECK(executor.getLoad() == std::vector<size_t>{0, 0});
+
+  // a net can be submitted again once its run finished.
+  CHECK(nets.front()->reuseApplication("again"));
+  CHECK(executor.submit(*nets.front()).get() == Success);
+}
+
+TEST_CASE("Submitting a net does not block the calling thread") {
+  auto pool = std::make_shared<TaskSystem>(4);
+  const NetTemplate net({{"t", {{{"Pa", Success}}, {{"Pb", Success}}}}},
+                        {{"Pa", Success}});
+  Executor executor(2);
+  std::promise<void> release;
+  const auto released = release.get_future().share();
+
+  std::vector<std::unique_ptr<PetriNet>> nets;
+  std::vector<std::future<Token>> results;
+  for (size_t i = 0; i < 4; i++) {
+    nets.push_back(std::make_unique<PetriNet>(net, "case" + std::to_string(i),
+                                              pool, Marking{{"Pb", Success}}));
+    nets.back()->registerCallback("t", [released] {
+      released.wait();
+      return Success;
+    });
+    results.push_back(executor.submit(*nets.back()));
+  }
+  const auto load = executor.getLoad();
+  CHECK(load[0] + load[1] == 4);
+  // a net that is already running is not submitted again.
+  CHECK(executor.submit(*nets.front()).get() == Failed);
+  for (auto& result : results) {
+    CHECK(result.wait_for(std::chrono::milliseconds(0)) ==
+          std::future_status::timeout);
+  }
+
+  release.set_value();
+  for (auto& result : results) {
+    CHECK(result.get() == Success);
+  }
+  CHECK(executor.getLoad() == std::vector<size_t>{0, 0});
+}
+
+TEST_CASE("Runs on an Executor can be cancelled") {
+  auto pool = std::make_shared<TaskSystem>(1);
+  PetriNet app({{"t", {{{"Pa", Success}}, {{"Pb", Success}}}}}, "cancel", pool,
+               {{"Pa", Success}}, {{"Pc", Success}});
+  std::promise<void> release;
+  app.registerCallback("t", [released = release.get_future().share()] {
+    released.wait();
+    return Success;
+  });
+  Executor executor;
+  auto result = executor.submit(app);
+  cancel(app);
+  release.set_value();
+  CHECK(result.get() == Canceled);
+}
@@ -0,0 +1,116 @@
+#include "symmetri/histogram.h"
+
+#include <stdint.h>
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "doctest/doctest.h"
+
+using namespace symmetri;
+
+TEST_CASE("Buckets cover all values without gaps") {
+  CHECK(Histogram::bucketOf(0) == 0);
+  CHECK(Histogram::bucketOf(63) == 63);
+  CHECK(Histogram::upperBound(Histogram::bucket_count - 1) ==
+        (uint64_t(1) << Histogram::max_bits) - 1);
+  for (size_t b = 1; b < Histogram::bucket_count; b++) {
+    const auto lower = Histogram::upperBound(b - 1) + 1;
+    CHECK(Histogram::bucketOf(lower) == b);
+    CHECK(Histogram::bucketOf(Histogram::upperBound(b)) == b);
+    // a bucket is at most ~3% of its values wide.
+    CHECK(Histogram::upperBound(b) - lower <= lower / 32);
+  }
+  CHECK(Histogram::bucketOf(uint64_t(1) << 50) == Histogram::bucket_count - 1);
+}
+
+TEST_CASE("A histogram tracks count, sum, extremes and percentiles") {
+  Histogram h;
+  CHECK(h.count() == 0);
+  CHECK(h.min() == 0);
+  CHECK(h.percentile(50) == 0);
+  for (uint64_t v = 1; v <= 1000; v++) {
+    h.record(v * 1000);
+  }
+  CHECK(h.count() == 1000);
+  CHECK(h.sum() == 500500000);
+  CHECK(h.min() == 1000);
+  CHECK(h.max() == 1000000);
+  CHECK(h.mean() == doctest::Approx(500500.0));
+  CHECK(h.percentile(0) == doctest::Approx(1000).epsilon(0.04));
+  CHECK(h.percentile(50) == doctest::Approx(500000).epsilon(0.04));
+  CHECK(h.percentile(99) == doctest::Approx(990000).epsilon(0.04));
+  CHECK(h.percentile(100) == 1000000);
+  CHECK(h.countAtMost(999) == 0);
+  CHECK(h.countAtMost(1000000) == 1000);
+  CHECK(h.countAtMost(250000) == doctest::Approx(250).epsilon(0.04));
+}
+
+TEST_CASE("Merging histograms is like recording all their values in one") {
+  std::mt19937 random(3);
+  std::uniform_int_distribution<uint64_t> values(0, 10000000);
+  Histogram a, b, all;
+  for (int i = 0; i < 1000; i++) {
+    const auto v = values(random);
+    (i % 3 == 0 ? a : b).record(v);
+    all.record(v);
+  }
+  a.merge(b);
+  a.merge(Histogram{});
+  CHECK(a.count() == all.count());
+  CHECK(a.sum() == all.sum());
+  CHECK(a.min() == all.min());
+  CHECK(a.max() == all.max());
+  for (size_t bucket = 0; bucket < Histogram::bucket_count; bucket++) {
+    CHECK(a.bucket(bucket) == all.bucket(bucket));
+  }
+}
+
+TEST_CASE("Latencies are exported as JSON and in the Prometheus format") {
+  Latencies latencies{"run \"1\"", {{"t0", {}, {}, {}}, {"t1", {}, {}, {}}}};
+  latencies.transitions[0].queueing.record(2000);
+  latencies.transitions[0].service.record(3000000);
+  latencies.transitions[0].delivery.record(40);
+
+  const auto json = writeLatenciesJson(latencies);
+  CHECK(json.find("\"case_id\":\"run \\\"1\\\"\"") != std::string::npos);
+  CHECK(json.find("{\"transition\":\"t0\",\"queueing\":{\"count\":1,"
+                  "\"sum\":2000,\"min\":2000,\"max\":2000") !=
+        std::string::npos);
+  CHECK(json.find("\"delivery\":{\"count\":1,\"sum\":40,\"min\":40,"
+                  "\"max\":40,\"mean\":40,\"p50\":40,\"p90\":40,\"p99\":40,"
+                  "\"p999\":40,\"buckets\":[[40,1]]}") != std::string::npos);
+  CHECK(json.find("{\"transition\":\"t1\",\"queueing\":{\"count\":0,") !=
+        std::string::npos);
+
+  const auto text = writeLatenciesPrometheus(latencies);
+  const std::string labels = "{case_id=\"run \\\"1\\\"\",transition=\"t0\"";
+  CHECK(text.find("# TYPE symmetri_transition_queueing_seconds histogram\n") !=
+        std::string::npos);
+  CHECK(text.find("symmetri_transition_queueing_seconds_bucket" + labels +
+                  ",le=\"1e-06\"} 0\n") != std::string::npos);
+  CHECK(text.find("symmetri_transition_queueing_seconds_bucket" + labels +
+                  ",le=\"2.5e-06\"} 1\n") != std::string::npos);
+  CHECK(text.find("symmetri_transition_service_seconds_bucket" + labels +
+                  ",le=\"0.0025\"} 0\n") != std::string::npos);
+  CHECK(text.find("symmetri_transition_service_seconds_bucket" + labels +
+                  ",le=\"+Inf\"} 1\n") != std::string::npos);
+  CHECK(text.find("symmetri_transition_service_seconds_sum" + labels +
+                  "} 0.003\n") != std::string::npos);
+  CHECK(text.find("symmetri_transition_delivery_seconds_count" + labels +
+                  "} 1\n") != std::string::npos);
+  // transitions that did not fire asynchronously are left out.
+  CHECK(text.find("transition=\"t1\"") == std::string::npos);
+
+  const std::string path = "latencies.prom";
+  REQUIRE(writeLatenciesPrometheusFile(latencies, path));
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  CHECK(contents.str() == text);
+  std::remove(path.c_str());
+  CHECK_FALSE(writeLatenciesPrometheusFile(latencies, "no/such/dir/x.prom"));
+}
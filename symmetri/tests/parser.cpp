@@ -1,4 +1,10 @@
+#include <cstdio>
 #include <filesystem>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <tuple>
 
 #include "doctest/doctest.h"
 #include "symmetri/parsers.h"
@@ -61,6 +67,65 @@ TEST_CASE("Load p1.grml net") {
   CHECK(stateNetEquality(net_test, net));
 }
 
+TEST_CASE("Load the bounds of p1.pnml and p1.grml nets") {
+  const auto assets = std::filesystem::current_path().append(
+      "../../../symmetri/tests/assets/");
+  const std::set<std::string> pnml_file = {
+      std::filesystem::path(assets).append("n1.pnml")};
+  const std::set<std::string> grml_file = {
+      std::filesystem::path(assets).append("n1.grml")};
+  const auto &[pnml_net, pnml_m0, pnml_limits, pnml_capacities] =
+      readPnmlWithBounds(pnml_file);
+  const auto &[grml_net, grml_m0, grml_priorities, grml_limits,
+               grml_capacities] = readGrmlWithBounds(grml_file);
+
+  // the net is read in the same pass, the same as without the bounds.
+  CHECK(stateNetEquality(pnml_net, std::get<Net>(readPnml(pnml_file))));
+  CHECK(stateNetEquality(grml_net, std::get<Net>(readGrml(grml_file))));
+
+  // only t4 and P7 are bounded in both nets.
+  const BoundTable limits_expected = {{"t4", 1}};
+  const BoundTable capacities_expected = {{"P7", 1}};
+  CHECK(pnml_limits == limits_expected);
+  CHECK(pnml_capacities == capacities_expected);
+  CHECK(grml_limits == limits_expected);
+  CHECK(grml_capacities == capacities_expected);
+}
+
+TEST_CASE("Bounds that are missing or out of range are rejected") {
+  const auto write = [](const std::string &path, const std::string &xml) {
+    std::ofstream(path) << xml;
+    return std::set<std::string>{path};
+  };
+  const auto pnml = [&](const std::string &capacity) {
+    return write("bound.pnml",
+                 "<pnml><net><page><place id=\"P0\"><capacity>" + capacity +
+                     "</capacity></place></page></net></pnml>");
+  };
+  const auto grml = [&](const std::string &value) {
+    return write("bound.grml",
+                 "<model><node id=\"1\" nodeType=\"place\">"
+                 "<attribute name=\"name\">P0</attribute>"
+                 "<attribute name=\"capacity\"><attribute name=\"expr\">"
+                 "<attribute name=\"intValue\">" +
+                     value + "</attribute></attribute></attribute>"
+                             "</node></model>");
+  };
+
+  CHECK(std::get<3>(readPnmlWithBounds(pnml("<text>4294967295</text>"))) ==
+        BoundTable{{"P0", 4294967295}});
+  CHECK_THROWS_AS(readPnmlWithBounds(pnml("")), std::runtime_error);
+  CHECK_THROWS_AS(readPnmlWithBounds(pnml("<text>-1</text>")),
+                  std::runtime_error);
+  CHECK_THROWS_AS(readPnmlWithBounds(pnml("<text>4294967296</text>")),
+                  std::runtime_error);
+  CHECK(std::get<4>(readGrmlWithBounds(grml("7"))) == BoundTable{{"P0", 7}});
+  CHECK_THROWS_AS(readGrmlWithBounds(grml("")), std::runtime_error);
+  CHECK_THROWS_AS(readGrmlWithBounds(grml("-1")), std::runtime_error);
+  std::remove("bound.pnml");
+  std::remove("bound.grml");
+}
+
 TEST_CASE("Load p1_multi.pnml net") {
   const std::string pnml_file = std::filesystem::current_path().append(
       "../../../symmetri/tests/assets/n1_multi.pnml");
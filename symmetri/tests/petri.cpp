@@ -1,7 +1,9 @@
 #include "petri.h"
 
+#include <atomic>
 #include <iostream>
 #include <map>
+#include <thread>
 
 #include "doctest/doctest.h"
 #include "symmetri/utilities.hpp"
@@ -68,25 +70,52 @@ TEST_CASE("Run one transition iteration in a petri net") {
     Marking expected = {{"Pa", Success}, {"Pa", Success}};
     CHECK(MarkingEquality(m.getMarking(), expected));
   }
-  // now there should be two reducers;
-  Reducer r1, r2;
-  CHECK(m.reducer_queue->wait_dequeue_timed(r1, std::chrono::seconds(1)));
-  CHECK(m.reducer_queue->wait_dequeue_timed(r1, std::chrono::seconds(1)));
-  CHECK(m.reducer_queue->wait_dequeue_timed(r2, std::chrono::seconds(1)));
-  CHECK(m.reducer_queue->wait_dequeue_timed(r2, std::chrono::seconds(1)));
+  // now there should be two completions;
+  Completion c1, c2;
+  const auto dequeue = [&m](Completion& c) {
+    const auto deadline = Clock::now() + std::chrono::seconds(1);
+    while (!m.completion_queue->tryDequeue(c)) {
+      if (Clock::now() > deadline) {
+        return false;
+      }
+      std::this_thread::yield();
+    }
+    return true;
+  };
+  CHECK(dequeue(c1));
+  CHECK(dequeue(c2));
   // verify that t0 has actually ran twice.
   CHECK(T0_COUNTER.load() == 2);
+  CHECK(c1.transition == toIndex(m.net.transition, "t0"));
+  CHECK(c1.result == Success);
+  CHECK(c1.start <= c1.end);
+  // both firings of t0 are active instances of their own.
+  CHECK(m.scheduled_callbacks.size() == 2);
+  CHECK(c1.instance != c2.instance);
+  CHECK(m.scheduled_callbacks.find(c1.instance) != nullptr);
+  CHECK(m.scheduled_callbacks.find(c2.instance) != nullptr);
   // the marking should still be the same.
   {
     Marking expected = {{"Pa", Success}, {"Pa", Success}};
     CHECK(MarkingEquality(m.getMarking(), expected));
   }
 
-  // process the reducers
-  r1(m);
-  r2(m);
+  // the latency histograms are only allocated once a firing is applied.
+  CHECK(m.latencies.empty());
+
+  // process the completions
+  const auto applied = Clock::now();
+  m.complete(c1, applied);
+  m.complete(c2, applied);
   // and now the post-conditions are processed:
   CHECK(m.scheduled_callbacks.empty());
+  // and the latencies of both firings are recorded.
+  const auto t0 = toIndex(m.net.transition, "t0");
+  const auto latency = m.getLatencies().transitions[t0];
+  CHECK(latency.transition == "t0");
+  CHECK(latency.queueing.count() == 2);
+  CHECK(latency.service.count() == 2);
+  CHECK(latency.delivery.count() == 2);
   {
     Marking expected = {
         {"Pa", Success}, {"Pa", Success}, {"Pc", Success}, {"Pc", Success}};
@@ -94,6 +123,60 @@ TEST_CASE("Run one transition iteration in a petri net") {
   }
 }
 
+TEST_CASE("Completions only mark their output places as dirty") {
+  auto [net, priority, m0] = PetriTestNet();
+  auto threadpool = std::make_shared<TaskSystem>(1);
+  Petri m(net, priority, m0, {}, "s", threadpool);
+  m.net.registerCallback("t0", &petri0);
+
+  // the initial marking is dirty, firing consumes it.
+  CHECK(m.tokens.dirtyPlaces().size() == 2);
+  m.fireTransitions();
+  CHECK(m.tokens.dirtyPlaces().empty());
+
+  while (!m.scheduled_callbacks.empty()) {
+    REQUIRE(m.processEvents(1000000) > 0);
+  }
+  CHECK(m.tokens.dirtyPlaces() ==
+        std::vector<size_t>{toIndex(m.net.place, "Pc")});
+
+  // t1 is the only consumer of Pc, and is now enabled.
+  ReadyQueue ready(m.net.transition.size());
+  possibleTransitions(m.tokens, m.net.input_n, m.net.p_to_ts_n, m.net.priority,
+                      m.enabling, ready);
+  REQUIRE(!ready.empty());
+  CHECK(ready.top() == toIndex(m.net.transition, "t1"));
+  ready.pop();
+  CHECK(ready.empty());
+}
+
+TEST_CASE("Instances keep their id until they are removed") {
+  ActiveSet active;
+  const auto now = Clock::now();
+  const auto a = active.insert(3, now);
+  const auto b = active.insert(3, now);
+  const auto c = active.insert(5, now);
+  CHECK(a != 0);
+  CHECK(a != b);
+  CHECK(active.size() == 3);
+
+  // removing moves the last instance, which keeps its id.
+  CHECK(active.erase(a));
+  CHECK(!active.erase(a));
+  CHECK(active.find(a) == nullptr);
+  CHECK(active.find(b)->transition == 3);
+  CHECK(active.find(c)->transition == 5);
+
+  // a reused slot gets a new id.
+  const auto d = active.insert(7, now);
+  CHECK(d != a);
+  CHECK(active.find(a) == nullptr);
+  CHECK(active.find(d)->transition == 7);
+  active.clear();
+  CHECK(active.empty());
+  CHECK(active.find(b) == nullptr);
+}
+
 TEST_CASE("Run until net dies") {
   using namespace moodycamel;
 
@@ -103,16 +186,12 @@ TEST_CASE("Run until net dies") {
   m.net.registerCallback("t0", &petri0);
   m.net.registerCallback("t1", &petri1);
 
-  Reducer r;
-  Callback a([] {});
-  // we need to enqueue one 'no-operation' to start the live net.
-  m.reducer_queue->enqueue([](Petri&) {});
-  do {
-    if (m.reducer_queue->try_dequeue(r)) {
-      r(m);
+  m.fireTransitions();
+  while (m.scheduled_callbacks.size() > 0) {
+    if (m.processEvents(1000000) > 0) {
       m.fireTransitions();
     }
-  } while (m.scheduled_callbacks.size() > 0);
+  }
 
   // For this specific net we expect:
   Marking expected = {
@@ -132,15 +211,12 @@ TEST_CASE("Run until net dies with DirectMutations") {
   auto threadpool = std::make_shared<TaskSystem>(1);
   Petri m(net, priority, m0, {}, "s", threadpool);
 
-  Reducer r;
-  // we need to enqueue one 'no-operation' to start the live net.
-  m.reducer_queue->enqueue([](Petri&) {});
-  do {
-    if (m.reducer_queue->try_dequeue(r)) {
-      r(m);
+  m.fireTransitions();
+  while (m.scheduled_callbacks.size() > 0) {
+    if (m.processEvents(1000000) > 0) {
       m.fireTransitions();
     }
-  } while (m.scheduled_callbacks.size() > 0);
+  }
   // For this specific net we expect:
   Marking expected = {
       {"Pb", Success}, {"Pb", Success}, {"Pd", Success}, {"Pd", Success}};
@@ -172,14 +248,9 @@ TEST_CASE("Fire multiple transitions") {
     CHECK(m.scheduled_callbacks.size() == 4);
     // there should be no markers left.
     CHECK(m.getMarking().size() == 0);
-    int j = 0;
-    Reducer r;
-    while (j < 2 * 4 &&
-           m.reducer_queue->wait_dequeue_timed(r, std::chrono::seconds(1))) {
-      j++;
-      r(m);
+    while (!m.scheduled_callbacks.empty() && m.processEvents(1000000) > 0) {
     }
-    // reducers update, there should be active transitions left.
+    // completions update, there should be active transitions left.
     CHECK(m.scheduled_callbacks.size() == 0);
   }
 
@@ -190,6 +261,33 @@ TEST_CASE("Fire multiple transitions") {
   CHECK(hitmap.at("a") + hitmap.at("b") + hitmap.at("c") + hitmap.at("d") == 4);
 }
 
+TEST_CASE("Events are applied in batches of at most the maximum batch size") {
+  Net net = {{"a", {{{"Pa", Success}}, {{"Pb", Success}}}}};
+  auto threadpool = std::make_shared<TaskSystem>(2);
+  Marking m0(7, {"Pa", Success});
+  Petri m(net, {}, m0, {}, "s", threadpool);
+  std::atomic<int> fired = 0;
+  m.net.registerCallback("a", [&] { fired++; });
+  m.max_batch_size = 3;
+
+  m.fireTransitions();
+  REQUIRE(m.scheduled_callbacks.size() == 7);
+  m.reducer_queue->enqueue([](Petri&) {});
+  while (!m.scheduled_callbacks.empty()) {
+    REQUIRE(m.processEvents(1000000) <= 3);
+  }
+
+  const auto& statistics = m.batch_statistics;
+  CHECK(fired == 7);
+  CHECK(statistics.events == 8);
+  CHECK(statistics.batches >= 3);
+  CHECK(statistics.largest <= 3);
+  // batches of 1 and of 2 or 3 events.
+  CHECK(statistics.histogram[0] + statistics.histogram[1] ==
+        statistics.batches);
+  CHECK(m.getMarking().size() == 7);
+}
+
 TEST_CASE("create fireable transitions shortlist") {
   auto [net, priority, m0] = PetriTestNet();
   auto threadpool = std::make_shared<TaskSystem>(1);
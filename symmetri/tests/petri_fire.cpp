@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "doctest/doctest.h"
 #include "petri.h"
 #include "symmetri/utilities.hpp"
@@ -23,3 +25,155 @@ TEST_CASE("transitions with no inputs can not fire") {
   std::vector<AugmentedToken> empty = {};
   CHECK(!canFire({}, empty));
 }
+
+TEST_CASE("can fire with a dense marking") {
+  DenseMarking tokens(2);
+  const std::vector<Arc> pre_conditions = {{1, Success}, {1, Success}};
+  CHECK(!tokens.canFire(pre_conditions));
+
+  // wrong token type
+  tokens.add(1, Token("bla"));
+  tokens.add(1, Success);
+  CHECK(!tokens.canFire(pre_conditions));
+
+  // the second token satisfies the weight of the arc
+  tokens.add(1, Success);
+  CHECK(tokens.canFire(pre_conditions));
+  CHECK(tokens.size() == 3);
+
+  tokens.deduct(pre_conditions);
+  CHECK(tokens.count(1, Success) == 0);
+  CHECK(tokens.count(1, Token("bla")) == 1);
+  CHECK(tokens.size() == 1);
+  CHECK(!tokens.canFire({}));
+}
+
+TEST_CASE("a dense marking converts back to tokens") {
+  std::vector<AugmentedToken> m0 = {
+      {0, Success}, {2, Failed}, {0, Success}, {1, Success}};
+  DenseMarking tokens(3);
+  tokens.reset(m0);
+  CHECK(MarkingEquality(tokens.toTokens(), m0));
+
+  tokens.reset({});
+  CHECK(tokens.toTokens().empty());
+}
+
+TEST_CASE("a dense marking keeps track of the places that got tokens") {
+  DenseMarking tokens(3);
+  tokens.reset({{2, Success}, {0, Success}, {2, Success}});
+  CHECK(tokens.dirtyPlaces() == std::vector<size_t>{2, 0});
+
+  tokens.clearDirty();
+  tokens.deduct({{2, Success}});
+  CHECK(tokens.dirtyPlaces().empty());
+
+  tokens.add(1, Success);
+  tokens.add(1, Success);
+  CHECK(tokens.dirtyPlaces() == std::vector<size_t>{1});
+}
+
+TEST_CASE("a dense marking tracks whether the goal is reached") {
+  DenseMarking tokens(3);
+  // no goal, so it is never reached
+  CHECK(!tokens.goalReached());
+
+  tokens.setGoal({{0, Success}, {1, Failed}, {0, Success}});
+  CHECK(!tokens.goalReached());
+  tokens.reset({{0, Success}, {0, Success}, {2, Success}});
+  CHECK(!tokens.goalReached());
+  tokens.add(1, Failed);
+  CHECK(tokens.goalReached());
+
+  // places outside of the goal do not matter, too many tokens in a goal
+  // place do.
+  tokens.add(2, Failed);
+  CHECK(tokens.goalReached());
+  tokens.add(0, Success);
+  CHECK(!tokens.goalReached());
+  tokens.deduct({{0, Success}});
+  CHECK(tokens.goalReached());
+
+  // setting the goal takes the current marking into account.
+  tokens.setGoal({{2, Failed}});
+  CHECK(tokens.goalReached());
+  tokens.setGoal({{3, Failed}});
+  CHECK(!tokens.goalReached());
+}
+
+TEST_CASE("the bit-parallel engine agrees with the generic check") {
+  // a weighted arc can not be checked with bits.
+  const auto arcs = [](const std::vector<std::vector<Arc>>& rows) {
+    return ArcTable::fromRows(rows, [](const Arc& arc) { return arc; });
+  };
+  CHECK(!EnablingEngine::isBitParallel(arcs({{{1, Success}, {1, Success}}})));
+
+  // t0: p0 -> , t1: p0 + p1 -> , t2: -> , t3: p2 (Failed) ->
+  const auto input_n =
+      arcs({{{0, Success}}, {{0, Success}, {1, Success}}, {}, {{2, Failed}}});
+  REQUIRE(EnablingEngine::isBitParallel(input_n));
+
+  DenseMarking tokens(3);
+  const EnablingEngine engine(input_n);
+  engine.watch(tokens);
+  CHECK(engine.isBitParallel());
+  REQUIRE(engine.hasBulk());
+
+  const auto check = [&](std::vector<size_t> expected) {
+    std::vector<uint64_t> enabled;
+    engine.enabledTransitions(tokens, enabled);
+    for (size_t t = 0; t < input_n.size(); t++) {
+      const bool is_expected =
+          std::find(expected.begin(), expected.end(), t) != expected.end();
+      CHECK(engine.canFire(t, input_n[t], tokens) == is_expected);
+      CHECK(tokens.canFire(input_n[t]) == is_expected);
+      CHECK(((enabled[0] >> t) & 1) == is_expected);
+    }
+  };
+
+  check({});
+  tokens.add(0, Success);
+  check({0});
+  tokens.add(1, Success);
+  tokens.add(1, Success);
+  check({0, 1});
+  tokens.add(2, Success);
+  check({0, 1});
+  tokens.add(2, Failed);
+  check({0, 1, 3});
+  tokens.deduct({{0, Success}});
+  check({3});
+  tokens.reset({{0, Success}, {1, Success}});
+  check({0, 1});
+}
+
+TEST_CASE("a CSR table groups its entries by row") {
+  const CsrTable<uint32_t> table(
+      4, {{2, 10}, {0, 11}, {2, 12}, {3, 13}, {0, 14}});
+  REQUIRE(table.size() == 4);
+  CHECK(table.elementCount() == 5);
+  CHECK(std::vector<uint32_t>(table[0].begin(), table[0].end()) ==
+        std::vector<uint32_t>{11, 14});
+  CHECK(table[1].empty());
+  CHECK(std::vector<uint32_t>(table[2].begin(), table[2].end()) ==
+        std::vector<uint32_t>{10, 12});
+  CHECK(table[3].size() == 1);
+  CHECK(table[3][0] == 13);
+}
+
+TEST_CASE("the CSR reverse lookup agrees with the vector one") {
+  // t0: p1 + p1 + p0 -> , t1: p1 (Failed) + p2 -> , t2: ->
+  const std::vector<SmallVectorInput> inputs = {
+      {{1, Success}, {1, Success}, {0, Success}},
+      {{1, Failed}, {2, Success}},
+      {}};
+  auto input_n = createArcTable(inputs);
+  input_n.sortRows();
+  const auto p_to_ts_n = createReversePlaceToTransitionLookup(3, input_n);
+  const auto expected = createReversePlaceToTransitionLookup(3, 3, inputs);
+  REQUIRE(p_to_ts_n.size() == expected.size());
+  for (size_t p = 0; p < expected.size(); p++) {
+    CHECK(std::equal(p_to_ts_n[p].begin(), p_to_ts_n[p].end(),
+                     expected[p].begin(), expected[p].end()));
+  }
+}
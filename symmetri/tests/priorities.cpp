@@ -22,11 +22,7 @@ TEST_CASE(
     m.net.registerCallback("t0", [] {});
     m.net.registerCallback("t1", [] {});
     m.fireTransitions();
-    Reducer r;
-
-    while (
-        m.reducer_queue->wait_dequeue_timed(r, std::chrono::milliseconds(1))) {
-      r(m);
+    while (m.processEvents(1000) > 0) {
     }
 
     auto prio_t0 = std::find_if(priority.begin(), priority.end(), [](auto e) {
@@ -73,3 +69,24 @@ TEST_CASE("Using DirectMutation does not queue reducers.") {
     }
   }
 }
+
+TEST_CASE("The ready queue pops the highest priority first, once.") {
+  ReadyQueue ready(130);
+  ready.push(0, 0);
+  ready.push(1, -128);
+  ready.push(129, 127);
+  ready.push(2, 64);
+  ready.push(129, 127);  // already queued, so ignored.
+  ready.push(3, -1);
+
+  std::vector<size_t> order;
+  while (!ready.empty()) {
+    order.push_back(ready.top());
+    ready.pop();
+  }
+  CHECK(order == std::vector<size_t>{129, 2, 0, 3, 1});
+
+  // popped transitions can be queued again.
+  ready.push(129, 0);
+  CHECK(ready.top() == 129);
+}
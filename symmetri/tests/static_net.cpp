@@ -0,0 +1,158 @@
+#include "symmetri/static_net.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "doctest/doctest.h"
+#include "nets/PT1.hpp"
+#include "symmetri/parsers.h"
+#include "symmetri/symmetri.h"
+
+using namespace symmetri;
+
+namespace {
+// the same net as SymmetriTestNet, but fixed at compile time.
+constexpr auto kNet = makeStaticNet(
+    {"Pa", "Pb", "Pc", "Pd"}, {"t0", "t1"},
+    {input("t0", "Pa"), input("t0", "Pb"), output("t0", "Pc"),
+     input("t1", "Pc"), input("t1", "Pc"), output("t1", "Pb"),
+     output("t1", "Pb"), output("t1", "Pd")},
+    {{"Pa"}, {"Pa"}, {"Pa"}, {"Pa"}, {"Pb"}, {"Pb"}});
+
+static_assert(kNet.place.size() == 4 && kNet.transition.size() == 2);
+static_assert(kNet.arc[3].transition == 1 && kNet.arc[3].place == 2 &&
+              kNet.arc[3].is_input);
+static_assert(kNet.arc[7].place == 3 && !kNet.arc[7].is_input);
+static_assert(kNet.initial_marking[5].place == 1 &&
+              kNet.initial_marking[5].color == "Success");
+}  // namespace
+
+TEST_CASE("A static net runs like the equivalent runtime net") {
+  auto threadpool = std::make_shared<TaskSystem>(1);
+  const Marking goal_marking(
+      {{"Pb", Success}, {"Pb", Success}, {"Pd", Success}, {"Pd", Success}});
+  PetriNet app(kNet, "static_net", threadpool, goal_marking);
+  app.registerCallback("t0", [] {});
+  CHECK(fire(app) == Success);
+  auto marking = app.getMarking();
+  std::sort(marking.begin(), marking.end());
+  CHECK(marking == Marking{{"Pb", Success},
+                           {"Pb", Success},
+                           {"Pd", Success},
+                           {"Pd", Success}});
+}
+
+TEST_CASE("A net compiled by symmetri_add_net can be constructed") {
+  // nets/PT1.hpp is generated from nets/PT1.pnml by the build.
+  static_assert(nets::PT1.place.size() == 2 &&
+                nets::PT1.transition.size() == 1);
+  PetriNet app(nets::PT1, "compiled_net", std::make_shared<TaskSystem>(1),
+               {{"P1", Success}});
+  app.registerCallback("T0", [] {});
+  CHECK(fire(app) == Success);
+  CHECK(app.getMarking() == Marking{{"P1", Success}});
+}
+
+TEST_CASE("A static net keeps its colors and priorities") {
+  // both transitions compete for the same token; only t_high may fire.
+  constexpr auto net =
+      makeStaticNet({"Pa", "Pb", "Pc"}, {{"t_low", -1}, {"t_high", 2}},
+                    {input("t_low", "Pa", "Foo"), output("t_low", "Pb"),
+                     input("t_high", "Pa", "Foo"), output("t_high", "Pc")},
+                    {{"Pa", "Foo"}});
+  static_assert(net.priority[0] == -1 && net.priority[1] == 2);
+  PetriNet app(net, "static_net_colors", std::make_shared<TaskSystem>(1),
+               {{"Pc", Success}});
+  CHECK(fire(app) == Success);
+  CHECK(app.getMarking() == Marking{{"Pc", Success}});
+}
+
+TEST_CASE("A static net without an initial marking deadlocks") {
+  constexpr auto net = makeStaticNet(
+      {"Pa", "Pb"}, {"t0"}, {input("t0", "Pa"), output("t0", "Pb")});
+  static_assert(net.initial_marking.empty());
+  PetriNet app(net, "static_net_empty", std::make_shared<TaskSystem>(1),
+               {{"Pb", Success}});
+  CHECK(fire(app) == Deadlocked);
+  CHECK(app.getMarking().empty());
+}
+
+TEST_CASE("A net can be written as a StaticNet header") {
+  const Net net = {{"t1", {{{"Pb", Success}}, {{"Pa", Token("Foo")}}}},
+                   {"t0", {{{"Pa", Success}, {"Pa", Success}}, {}}}};
+  const auto header = writeStaticNet(net, {{"Pa", Success}}, {{"t1", -3}},
+                                     "my_net", {{"t0", 2}}, {{"Pb", 5}});
+  CHECK(header == R"(#pragma once
+
+// Generated by symmetri_net_compiler, do not edit.
+
+#include "symmetri/static_net.hpp"
+
+namespace symmetri::nets {
+
+inline constexpr StaticNet<2, 2, 4, 1> my_net = {
+    {{
+        "Pa",
+        "Pb"
+    }},
+    {{
+        "t0",
+        "t1"
+    }},
+    {{
+        0,
+        -3
+    }},
+    {{
+        {0, 0, "Success", true},
+        {0, 0, "Success", true},
+        {1, 1, "Success", true},
+        {1, 0, "Foo", false}
+    }},
+    {{
+        {0, "Success"}
+    }},
+    {{
+        2,
+        0
+    }},
+    {{
+        0,
+        5
+    }},
+};
+
+}  // namespace symmetri::nets
+)");
+}
+
+TEST_CASE("The bounds of a static net hold for every PetriNet of it") {
+  constexpr auto net = [] {
+    auto net = makeStaticNet(
+        {"Pa", "Pb"}, {"t"}, {input("t", "Pa"), output("t", "Pb")},
+        {{"Pa"}, {"Pa"}, {"Pa"}, {"Pa"}, {"Pa"}, {"Pa"}, {"Pa"}, {"Pa"}});
+    net.max_in_flight[0] = 2;
+    return net;
+  }();
+  const Marking goal_marking(8, {"Pb", Success});
+  const auto most_in_flight = [&](const PetriNet& app) {
+    app.registerCallback("t", [] {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+      return Success;
+    });
+    CHECK(fire(app) == Success);
+    int in_flight = 0, most = 0;
+    for (const auto& e : getLog(app)) {
+      in_flight += e.state == Scheduled ? 1 : e.state == Success ? -1 : 0;
+      most = std::max(most, in_flight);
+    }
+    return most;
+  };
+  CHECK(most_in_flight(PetriNet(net, "static_bounds",
+                                std::make_shared<TaskSystem>(4),
+                                goal_marking)) == 2);
+  CHECK(most_in_flight(PetriNet(NetTemplate(net), "template_bounds",
+                                std::make_shared<TaskSystem>(4),
+                                goal_marking)) == 2);
+}
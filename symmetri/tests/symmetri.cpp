@@ -1,9 +1,16 @@
 #include "symmetri/symmetri.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <filesystem>
 #include <future>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
 
 #include "doctest/doctest.h"
 
@@ -59,6 +66,257 @@ TEST_CASE("Create a using the net constructor with end condition.") {
   CHECK(!ev.empty());
 }
 
+TEST_CASE("Instances of a NetTemplate share the net but not the state.") {
+  auto threadpool = std::make_shared<TaskSystem>(1);
+  auto [net, priority, initial_marking] = SymmetriTestNet();
+  std::optional<NetTemplate> compiled_net(
+      std::in_place, net, initial_marking, priority);
+  Marking goal_marking(
+      {{"Pb", Success}, {"Pb", Success}, {"Pd", Success}, {"Pd", Success}});
+  PetriNet a(*compiled_net, "instance_a", threadpool, goal_marking);
+  PetriNet b(*compiled_net, "instance_b", threadpool);
+  // the instances outlive the template.
+  compiled_net.reset();
+
+  int a_count = 0;
+  a.registerCallback("t0", [&] { a_count++; });
+  b.registerCallback("t1", [] { return Failed; });
+
+  // a reaches its goal, which does not affect the marking of b.
+  CHECK(fire(a) == Success);
+  CHECK(a_count == 4);
+  CHECK(b.getMarking().size() == initial_marking.size());
+
+  // b has different callbacks and no goal, so it deadlocks in another marking.
+  CHECK(fire(b) == Deadlocked);
+  const auto marking = b.getMarking();
+  CHECK(std::count(marking.begin(), marking.end(),
+                   std::pair<std::string, Token>("Pb", Failed)) == 2);
+  const auto log = getLog(b);
+  CHECK(std::all_of(log.begin(), log.end(),
+                    [](const auto& e) { return e.case_id == "instance_b"; }));
+}
+
+TEST_CASE("Run a net with an event loop that polls before blocking.") {
+  auto threadpool = std::make_shared<TaskSystem>(1, WaitPolicy{1000, 1000});
+  auto [net, priority, initial_marking] = SymmetriTestNet();
+  Marking goal_marking(
+      {{"Pb", Success}, {"Pb", Success}, {"Pd", Success}, {"Pd", Success}});
+  PetriNet app(net, "test_net_polling", threadpool, initial_marking,
+               goal_marking, priority);
+  app.setWaitPolicy({1000, 1000});
+  app.registerCallback("t0", &t0);
+  app.registerCallback("t1", &t1);
+  CHECK(fire(app) == Success);
+}
+
+TEST_CASE("Run nested nets on a work-stealing executor.") {
+  auto threadpool = std::make_shared<TaskSystem>(2, WaitPolicy{},
+                                                 Scheduling::WorkStealing);
+  auto [net, priority, initial_marking] = SymmetriTestNet();
+  Marking goal_marking(
+      {{"Pb", Success}, {"Pb", Success}, {"Pd", Success}, {"Pd", Success}});
+  PetriNet child(net, "child", threadpool, initial_marking, goal_marking,
+                 priority);
+  PetriNet parent(net, "parent", threadpool, initial_marking, goal_marking,
+                  priority);
+  // the child runs on a worker and pushes its transitions from there.
+  parent.registerCallback("t1", child);
+  CHECK(fire(parent) == Success);
+}
+
+TEST_CASE("Nest nets deeper than the threadpool has threads.") {
+  // every level waits for the level below; blocking nets would need a thread
+  // per level.
+  auto threadpool = std::make_shared<TaskSystem>(1);
+  const Net net = {{"t", {{{"Pa", Success}}, {{"Pb", Success}}}}};
+  std::vector<PetriNet> levels;
+  for (size_t i = 0; i < 8; i++) {
+    levels.emplace_back(net, "level_" + std::to_string(i), threadpool,
+                        Marking{{"Pa", Success}}, Marking{{"Pb", Success}});
+  }
+  for (size_t i = 0; i + 1 < levels.size(); i++) {
+    levels[i].registerCallback("t", levels[i + 1]);
+  }
+  levels.back().registerCallback("t", [] {});
+  CHECK(fire(levels.front()) == Success);
+}
+
+namespace {
+
+struct RecordThread {
+  std::vector<std::thread::id>* threads;
+};
+
+bool isSynchronous(const RecordThread&) { return true; }
+
+Token fire(const RecordThread& callback) {
+  callback.threads->push_back(std::this_thread::get_id());
+  return Success;
+}
+
+}  // namespace
+
+TEST_CASE("Nested nets run on the loop of their parent.") {
+  auto threadpool = std::make_shared<TaskSystem>(1);
+  const Net net = {{"t", {{{"Pa", Success}}, {{"Pb", Success}}}}};
+  std::vector<PetriNet> levels;
+  for (size_t i = 0; i < 3; i++) {
+    levels.emplace_back(net, "level_" + std::to_string(i), threadpool,
+                        Marking{{"Pa", Success}}, Marking{{"Pb", Success}});
+  }
+  levels[0].registerCallback("t", levels[1]);
+  levels[1].registerCallback("t", levels[2]);
+  // synchronous Callbacks run on the thread that processes the events.
+  std::vector<std::thread::id> threads;
+  levels[2].registerCallback("t", RecordThread{&threads});
+
+  CHECK(fire(levels.front()) == Success);
+  CHECK(threads == std::vector<std::thread::id>{std::this_thread::get_id()});
+  // the events of the nested nets are part of the log of the parent.
+  const auto log = getLog(levels.front());
+  for (const auto case_id : {"level_0", "level_1", "level_2"}) {
+    CHECK(std::any_of(log.begin(), log.end(), [case_id](const Event& e) {
+      return e.case_id == case_id && e.state == Success;
+    }));
+  }
+}
+
+TEST_CASE("Cancelling a parent cancels its nested nets.") {
+  // one thread runs the Callback of the child, the other the parent's loop.
+  auto threadpool = std::make_shared<TaskSystem>(2);
+  const Net net = {{"t", {{{"Pa", Success}}, {{"Pb", Success}}}}};
+  // the goals are not reachable, so only the cancel ends the runs.
+  PetriNet parent(net, "parent", threadpool, {{"Pa", Success}},
+                  {{"Pc", Success}});
+  PetriNet child(net, "child", threadpool, {{"Pa", Success}},
+                 {{"Pc", Success}});
+  std::promise<void> started, release;
+  child.registerCallback("t", [&started,
+                               ready = release.get_future().share()] {
+    started.set_value();
+    ready.wait();
+  });
+  parent.registerCallback("t", child);
+
+  std::promise<Token> result;
+  fire(parent, [&result](Token token) { result.set_value(token); });
+  started.get_future().wait();
+  // the log of the running child is read on the loop of the parent.
+  const auto log = getLog(parent);
+  CHECK(std::any_of(log.begin(), log.end(), [](const Event& e) {
+    return e.case_id == "child" && e.state == Scheduled;
+  }));
+
+  cancel(parent);
+  // the cancel reaches the child through the loop of the parent.
+  const auto is_cancelled = [](const Eventlog& events) {
+    return std::any_of(events.begin(), events.end(), [](const Event& e) {
+      return e.case_id == "child" && e.state == Cancel;
+    });
+  };
+  while (!is_cancelled(getLog(child))) {
+    std::this_thread::yield();
+  }
+  release.set_value();
+  CHECK(result.get_future().get() == Canceled);
+  CHECK(is_cancelled(getLog(parent)));
+}
+
+TEST_CASE("Fire a net without blocking the calling thread.") {
+  auto threadpool = std::make_shared<TaskSystem>(1);
+  const Net net = {{"t", {{{"Pa", Success}}, {{"Pb", Success}}}}};
+  PetriNet app(net, "suspended", threadpool, {{"Pa", Success}},
+               {{"Pb", Success}});
+  std::promise<void> release;
+  app.registerCallback(
+      "t", [ready = release.get_future().share()] { ready.wait(); });
+
+  std::promise<Token> result;
+  fire(app, [&result](Token token) { result.set_value(token); });
+  // fire returned while t still waits.
+  auto future_result = result.get_future();
+  CHECK(future_result.wait_for(std::chrono::milliseconds(1)) ==
+        std::future_status::timeout);
+  std::promise<Token> second;
+  fire(app, [&second](Token token) { second.set_value(token); });
+  CHECK(second.get_future().get() == Failed);
+  release.set_value();
+  CHECK(future_result.get() == Success);
+}
+
+namespace {
+
+/**
+ * @brief Completes its firings when the test says so, like a Callback that
+ * waits for I/O.
+ */
+struct Deferred {
+  std::shared_ptr<std::vector<Continuation>> pending;
+  std::shared_ptr<std::mutex> mutex;
+};
+
+void fire(const Deferred& deferred, Continuation continuation) {
+  std::lock_guard<std::mutex> lock(*deferred.mutex);
+  deferred.pending->push_back(std::move(continuation));
+}
+
+}  // namespace
+
+TEST_CASE("Suspendable Callbacks do not occupy a thread while they wait.") {
+  static_assert(is_suspendable<Deferred>::value);
+  static_assert(is_suspendable<PetriNet>::value);
+  static_assert(!is_suspendable<DirectMutation>::value);
+
+  auto threadpool = std::make_shared<TaskSystem>(1);
+  const Net net = {{"t", {{{"Pa", Success}}, {{"Pb", Success}}}}};
+  const Marking m0(4, {"Pa", Success});
+  const Marking goal(4, {"Pb", Success});
+  PetriNet app(net, "deferred", threadpool, m0, goal);
+  Deferred deferred{std::make_shared<std::vector<Continuation>>(),
+                    std::make_shared<std::mutex>()};
+  app.registerCallback("t", deferred);
+
+  // all four firings are pending at once on a single thread.
+  std::thread io([&deferred] {
+    while (true) {
+      std::lock_guard<std::mutex> lock(*deferred.mutex);
+      if (deferred.pending->size() == 4) {
+        break;
+      }
+    }
+    for (auto& continuation : *deferred.pending) {
+      continuation(Success);
+    }
+  });
+  CHECK(fire(app) == Success);
+  io.join();
+}
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+TEST_CASE("Await nested nets from a coroutine Callback.") {
+  auto threadpool = std::make_shared<TaskSystem>(1);
+  const Net net = {{"t", {{{"Pa", Success}}, {{"Pb", Success}}}}};
+  PetriNet child_a(net, "a", threadpool, {{"Pa", Success}}, {{"Pb", Success}});
+  PetriNet child_b(net, "b", threadpool, {{"Pa", Success}}, {{"Pb", Success}});
+  PetriNet parent(net, "parent", threadpool, {{"Pa", Success}},
+                  {{"Pb", Success}});
+  int steps = 0;
+  parent.registerCallback("t", [&]() -> Async {
+    const auto a = co_await await(child_a);
+    steps++;
+    const auto b = co_await await(child_b);
+    steps++;
+    if (a == Success && b == Success) {
+      co_return Success;
+    }
+    co_return Failed;
+  });
+  CHECK(fire(parent) == Success);
+  CHECK(steps == 2);
+}
+#endif
+
 TEST_CASE("Create a using pnml constructor.") {
   const std::string pnml_file = std::filesystem::current_path().append(
       "../../../symmetri/tests/assets/PT1.pnml");
@@ -191,7 +449,7 @@ TEST_CASE("Test pause and resume") {
   PetriNet app(net, "random_id", threadpool, initial_marking, goal_marking);
   app.registerCallback("t0", [&] { i++; });
   int check1, check2;
-  threadpool->push([&, app, t1 = app.getInputTransitionHandle("t1")]() {
+  threadpool->push([&, t1 = app.getInputTransitionHandle("t1")]() {
     const auto dt = std::chrono::milliseconds(5);
     std::this_thread::sleep_for(dt);
     pause(app);
@@ -208,6 +466,453 @@ TEST_CASE("Test pause and resume") {
   CHECK(i.load() > check2);
   CHECK(i.load() > check2 + 1);
 }
+
+TEST_CASE("Delayed transitions fire once their delay expired.") {
+  // a transition that produces in its own input place fires at an interval.
+  Net net = {{"tick", {{{"Pa", Success}}, {{"Pa", Success}, {"Pb", Success}}}}};
+  auto threadpool = std::make_shared<TaskSystem>(1);
+  PetriNet app(net, "interval", threadpool, {{"Pa", Success}},
+               {{"Pb", Success}, {"Pb", Success}, {"Pb", Success}});
+  std::atomic<int> ticks = 0;
+  app.registerCallback("tick", [&] { ticks++; });
+  app.setDelay("tick", std::chrono::milliseconds(10));
+  const auto begin = Clock::now();
+  CHECK(fire(app) == Success);
+  CHECK(Clock::now() - begin >= std::chrono::milliseconds(30));
+  CHECK(ticks == 3);
+}
+
+TEST_CASE("Pending delays do not occupy a thread.") {
+  Net net = {{"t", {{{"Pa", Success}}, {{"Pb", Success}}}}};
+  Marking initial_marking, goal_marking;
+  for (int i = 0; i < 1000; i++) {
+    initial_marking.push_back({"Pa", Success});
+    goal_marking.push_back({"Pb", Success});
+  }
+  auto threadpool = std::make_shared<TaskSystem>(1);
+  PetriNet app(net, "delays", threadpool, initial_marking, goal_marking);
+  app.registerCallback("t", [] { return Success; });
+  app.setDelay("t", std::chrono::milliseconds(50));
+  const auto begin = Clock::now();
+  CHECK(fire(app) == Success);
+  const auto elapsed = Clock::now() - begin;
+  CHECK(elapsed >= std::chrono::milliseconds(50));
+  // one thread would take 50 seconds to sleep through all delays.
+  CHECK(elapsed < std::chrono::seconds(5));
+}
+
+TEST_CASE("Cancelling a net ends its pending delays.") {
+  Net net = {{"t0", {{{"Pa", Success}}, {{"Pb", Success}}}},
+             {"t1", {{{"Pb", Success}}, {{"Pc", Success}}}}};
+  auto threadpool = std::make_shared<TaskSystem>(1);
+  PetriNet app(net, "cancel", threadpool, {{"Pa", Success}},
+               {{"Pd", Success}});
+  std::promise<void> started;
+  app.registerCallback("t0", [&] { started.set_value(); });
+  std::atomic<bool> has_fired = false;
+  app.registerCallback("t1", [&] { has_fired = true; });
+  app.setDelay("t1", std::chrono::hours(1));
+  auto result = std::async(std::launch::async, [&] { return fire(app); });
+  // once the net runs, its loop answers the queries.
+  started.get_future().wait();
+  while (app.getActiveTransitions() != std::vector<Transition>{"t1"}) {
+    std::this_thread::yield();
+  }
+  cancel(app);
+  CHECK(result.get() == Canceled);
+  CHECK(!has_fired);
+  CHECK(app.getMarking() == Marking{{"Pc", Canceled}});
+
+  // t1 was cancelled while it waited, so its Callback never started.
+  std::vector<Token> t1_states;
+  for (const auto& e : getLog(app)) {
+    if (e.transition == "t1") {
+      t1_states.push_back(e.state);
+    }
+  }
+  CHECK(t1_states == std::vector<Token>{Scheduled, Cancel, Canceled});
+}
+
+namespace {
+
+struct Stuck {
+  std::shared_future<void> released;
+  std::shared_ptr<std::atomic<bool>> is_cancelled;
+};
+
+Token fire(const Stuck& stuck) {
+  stuck.released.wait();
+  return Success;
+}
+
+void cancel(const Stuck& stuck) { stuck.is_cancelled->store(true); }
+
+}  // namespace
+
+TEST_CASE("A Callback that misses its deadline is cancelled and times out.") {
+  Net net = {{"stuck", {{{"Pa", Success}}, {{"Pb", Success}}}},
+             {"fast", {{{"Pc", Success}}, {{"Pd", Success}}}}};
+  // the net holds the only reference to the threadpool, so it joins the stuck
+  // Callback before the net is gone.
+  PetriNet app(net, "deadline", std::make_shared<TaskSystem>(2),
+               {{"Pa", Success}, {"Pc", Success}},
+               {{"Pb", TimedOut}, {"Pd", Success}});
+  std::promise<void> release;
+  const auto is_cancelled = std::make_shared<std::atomic<bool>>(false);
+  app.registerCallback("stuck",
+                       Stuck{release.get_future().share(), is_cancelled});
+  app.registerCallback("fast", [] { return Success; });
+  app.setTimeout("stuck", std::chrono::milliseconds(10));
+  app.setTimeout("fast", std::chrono::seconds(10));
+
+  // the run does not wait for the stuck Callback, nor for the deadline of the
+  // one that completed in time.
+  const auto begin = Clock::now();
+  CHECK(fire(app) == Success);
+  CHECK(Clock::now() - begin < std::chrono::seconds(5));
+  CHECK(is_cancelled->load());
+  const auto log = getLog(app);
+  CHECK(std::count_if(log.begin(), log.end(), [](const Event& e) {
+          return e.state == TimedOut;
+        }) == 1);
+  CHECK(std::any_of(log.begin(), log.end(), [](const Event& e) {
+    return e.transition == "stuck" && e.state == TimedOut;
+  }));
+  release.set_value();
+}
+
+namespace {
+
+// the first firing is stuck until it is released, later ones wait until the
+// first one timed out.
+struct Overlapping {
+  std::shared_future<void> released;
+  std::shared_future<void> timed_out;
+  std::shared_ptr<std::atomic<int>> firings;
+  std::shared_ptr<std::atomic<bool>> is_cancelled;
+};
+
+Token fire(const Overlapping& overlapping) {
+  if ((*overlapping.firings)++ == 0) {
+    overlapping.released.wait();
+  } else {
+    overlapping.timed_out.wait();
+  }
+  return Success;
+}
+
+void cancel(const Overlapping& overlapping) {
+  overlapping.is_cancelled->store(true);
+}
+
+}  // namespace
+
+TEST_CASE("A firing that times out does not cancel the others that run") {
+  Net net = {{"t", {{{"Pa", Success}}, {{"Pb", Success}}}},
+             {"feed", {{{"Pc", Success}}, {{"Pa", Success}}}}};
+  PetriNet app(net, "overlapping", std::make_shared<TaskSystem>(3),
+               {{"Pa", Success}, {"Pc", Success}},
+               {{"Pb", TimedOut}, {"Pb", Success}});
+  std::promise<void> release, timed_out;
+  const auto firings = std::make_shared<std::atomic<int>>(0);
+  const auto is_cancelled = std::make_shared<std::atomic<bool>>(false);
+  app.registerCallback("t", Overlapping{release.get_future().share(),
+                                        timed_out.get_future().share(),
+                                        firings, is_cancelled});
+  // the second firing of t starts well before the first one times out, and
+  // has its deadline well after it.
+  app.registerCallback("feed", [] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  });
+  app.setTimeout("t", std::chrono::milliseconds(200));
+
+  auto result = std::async(std::launch::async, [&] { return fire(app); });
+  const auto has_timed_out = [&] {
+    const auto log = getLog(app);
+    return std::any_of(log.begin(), log.end(),
+                       [](const Event& e) { return e.state == TimedOut; });
+  };
+  // once t fires, the loop runs the net and answers the queries.
+  while (firings->load() == 0 || !has_timed_out()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  timed_out.set_value();
+  CHECK(result.get() == Success);
+  // both firings share the Callback, so it is not cancelled.
+  CHECK_FALSE(is_cancelled->load());
+  release.set_value();
+}
+
+TEST_CASE("A Callback that times out before it starts is never fired") {
+  // the only worker is busy, so the Callback is still queued at its deadline.
+  auto pool = std::make_shared<TaskSystem>(1);
+  std::promise<void> release;
+  auto busy = release.get_future().share();
+  pool->push([busy] { busy.wait(); });
+  const auto is_fired = std::make_shared<std::atomic<bool>>(false);
+  {
+    PetriNet app({{"late", {{{"Pa", Success}}, {{"Pb", Success}}}}},
+                 "not_started", pool, {{"Pa", Success}}, {{"Pb", TimedOut}});
+    app.registerCallback("late", [is_fired] {
+      is_fired->store(true);
+      return Success;
+    });
+    app.setTimeout("late", std::chrono::milliseconds(10));
+    CHECK(fire(app) == Success);
+  }
+  // the net is gone before its task runs.
+  release.set_value();
+  std::promise<void> idle;
+  pool->push([&idle] { idle.set_value(); });
+  idle.get_future().wait();
+  CHECK_FALSE(is_fired->load());
+}
+
+TEST_CASE("A transition never has more Callbacks in flight than its limit") {
+  Net net = {{"t", {{{"Pa", Success}}, {{"Pb", Success}}}}};
+  Marking initial_marking, goal_marking;
+  for (size_t i = 0; i < 100; i++) {
+    initial_marking.push_back({"Pa", Success});
+    goal_marking.push_back({"Pb", Success});
+  }
+  PetriNet app(net, "in_flight", std::make_shared<TaskSystem>(4),
+               initial_marking, goal_marking);
+  std::atomic<int> active(0), most_active(0);
+  app.registerCallback("t", [&] {
+    const auto now_active = ++active;
+    int most = most_active.load();
+    while (now_active > most &&
+           !most_active.compare_exchange_weak(most, now_active)) {
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+    active--;
+    return Success;
+  });
+  app.setMaxInFlight("t", 2);
+  CHECK(fire(app) == Success);
+  CHECK(most_active.load() <= 2);
+
+  // the loop schedules a Callback and logs its result once it completes.
+  int in_flight = 0, most_in_flight = 0;
+  for (const auto& e : getLog(app)) {
+    in_flight += e.state == Scheduled ? 1 : e.state == Success ? -1 : 0;
+    most_in_flight = std::max(most_in_flight, in_flight);
+  }
+  CHECK(most_in_flight == 2);
+}
+
+TEST_CASE("A full place holds back its producers") {
+  Net net = {{"produce", {{{"Pa", Success}}, {{"Pb", Success}}}},
+             {"consume", {{{"Pb", Success}}, {{"Pc", Success}}}}};
+  Marking initial_marking, goal_marking;
+  for (size_t i = 0; i < 20; i++) {
+    initial_marking.push_back({"Pa", Success});
+    goal_marking.push_back({"Pc", Success});
+  }
+  PetriNet app(net, "capacity", std::make_shared<TaskSystem>(2),
+               initial_marking, goal_marking);
+  app.registerCallback("consume", [] {
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+    return Success;
+  });
+  app.setCapacity("Pb", 3);
+  app.setMaxInFlight("consume", 1);
+  CHECK(fire(app) == Success);
+
+  // the synchronous producer fills Pb while the consumer is busy; the consumer
+  // takes a token from Pb when it is scheduled.
+  int tokens = 0, most_tokens = 0;
+  for (const auto& e : getLog(app)) {
+    if (e.transition == "produce" && e.state == Success) {
+      tokens++;
+    } else if (e.transition == "consume" && e.state == Scheduled) {
+      tokens--;
+    }
+    most_tokens = std::max(most_tokens, tokens);
+  }
+  CHECK(most_tokens == 3);
+}
+
+TEST_CASE("An input transition fired by its handle is bounded as well") {
+  Net net = {{"in", {{}, {{"P", Success}}}},
+             {"wait", {{{"Pgo", Success}}, {{"Pw", Success}}}},
+             {"a", {{{"Pw", Success}}, {{"P", Success}}}}};
+  PetriNet app(net, "handle_capacity", std::make_shared<TaskSystem>(2),
+               {{"Pgo", Success}}, {{"P", Success}, {"P", Success}});
+  const auto in = app.getInputTransitionHandle("in");
+  app.registerCallback("wait", [&] { in(); });
+  app.setCapacity("P", 5);
+  // the firing by the handle books its token like any other, so releasing it
+  // leaves room for a.
+  CHECK(fire(app) == Success);
+  CHECK(app.getMarking() == Marking{{"P", Success}, {"P", Success}});
+}
+
+TEST_CASE("An input transition fired by its handle waits for room") {
+  Net net = {{"in", {{}, {{"P", Success}}}},
+             {"go", {{{"Pgo", Success}}, {{"Pw", Success}}}},
+             {"take", {{{"P", Success}}, {{"Q", Success}}}}};
+  PetriNet app(net, "handle_held", std::make_shared<TaskSystem>(2),
+               {{"Pgo", Success}},
+               {{"Pw", Success}, {"Q", Success}, {"Q", Success},
+                {"Q", Success}});
+  const auto in = app.getInputTransitionHandle("in");
+  app.registerCallback("go", [&] {
+    in();
+    in();
+    in();
+  });
+  app.registerCallback("take", [] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  });
+  app.setCapacity("P", 1);
+  CHECK(fire(app) == Success);
+
+  // the held firings of in are only scheduled once take made room in P.
+  int tokens = 0, most_tokens = 0;
+  for (const auto& e : getLog(app)) {
+    if (e.transition == "in" && e.state == Scheduled) {
+      tokens++;
+    } else if (e.transition == "take" && e.state == Scheduled) {
+      tokens--;
+    }
+    most_tokens = std::max(most_tokens, tokens);
+  }
+  CHECK(most_tokens == 1);
+}
+
+TEST_CASE("A net of which all places are full is deadlocked") {
+  Net net = {{"t", {{{"Pa", Success}}, {{"Pb", Success}}}}};
+  PetriNet app(net, "full", std::make_shared<TaskSystem>(1),
+               {{"Pa", Success}, {"Pa", Success}, {"Pa", Success}},
+               {{"Pb", Success}, {"Pb", Success}, {"Pb", Success}});
+  app.setCapacity("Pb", 2);
+  CHECK(fire(app) == Deadlocked);
+  auto marking = app.getMarking();
+  std::sort(marking.begin(), marking.end());
+  CHECK(marking == Marking{{"Pa", Success}, {"Pb", Success}, {"Pb", Success}});
+}
+
+TEST_CASE("Concurrent firings of a transition are instances of their own") {
+  Net net = {{"t", {{{"Pa", Success}}, {{"Pb", Success}}}}};
+  Marking initial_marking, goal_marking;
+  for (size_t i = 0; i < 4; i++) {
+    initial_marking.push_back({"Pa", Success});
+    goal_marking.push_back({"Pb", Success});
+  }
+  PetriNet app(net, "instances", std::make_shared<TaskSystem>(4),
+               initial_marking, goal_marking);
+  std::atomic<int> arrived(0);
+  app.registerCallback("t", [&] {
+    // all four run at once.
+    arrived++;
+    while (arrived.load() < 4) {
+      std::this_thread::yield();
+    }
+    return Success;
+  });
+  CHECK(fire(app) == Success);
+
+  // every instance has its own id and its own stamps.
+  std::map<uint64_t, std::vector<Event>> instances;
+  for (const auto& e : getLog(app)) {
+    instances[e.instance].push_back(e);
+  }
+  REQUIRE(instances.size() == 4);
+  for (const auto& [instance, events] : instances) {
+    CHECK(instance != 0);
+    REQUIRE(events.size() == 3);
+    CHECK(events[0].state == Scheduled);
+    CHECK(events[1].state == Started);
+    CHECK(events[2].state == Success);
+    CHECK(events[0].stamp <= events[1].stamp);
+    CHECK(events[1].stamp <= events[2].stamp);
+  }
+}
+
+TEST_CASE("The latencies of asynchronous firings are recorded") {
+  Net net = {{"t", {{{"Pa", Success}}, {{"Pb", Success}}}},
+             {"t_sync", {{{"Pb", Success}}, {{"Pc", Success}}}}};
+  Marking initial_marking, goal_marking;
+  for (size_t i = 0; i < 3; i++) {
+    initial_marking.push_back({"Pa", Success});
+    goal_marking.push_back({"Pc", Success});
+  }
+  PetriNet app(net, "latencies", std::make_shared<TaskSystem>(1),
+               initial_marking, goal_marking);
+  std::optional<Latencies> during_run;
+  app.registerCallback("t", [&] {
+    if (!during_run.has_value()) {
+      // the snapshot is taken by the event loop while it runs.
+      during_run = app.getLatencies();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    return Success;
+  });
+  app.registerCallback("t_sync", DirectMutation{});
+  CHECK(fire(app) == Success);
+
+  const auto find = [](const Latencies& latencies, const std::string& name) {
+    return *std::find_if(latencies.transitions.begin(),
+                         latencies.transitions.end(),
+                         [&](const auto& t) { return t.transition == name; });
+  };
+  REQUIRE(during_run.has_value());
+  CHECK(during_run->case_id == "latencies");
+  CHECK(find(*during_run, "t").service.count() == 0);
+
+  const auto latencies = app.getLatencies();
+  REQUIRE(latencies.transitions.size() == 2);
+  const auto t = find(latencies, "t");
+  CHECK(t.queueing.count() == 3);
+  CHECK(t.service.count() == 3);
+  CHECK(t.delivery.count() == 3);
+  CHECK(t.service.min() >= 2000000);
+  // synchronous transitions are not timed.
+  CHECK(find(latencies, "t_sync").service.count() == 0);
+}
+
+namespace {
+
+// a synchronous Callback that tells the test it fired.
+struct Signal {
+  std::shared_ptr<std::promise<void>> fired;
+};
+
+bool isSynchronous(const Signal&) { return true; }
+
+Token fire(const Signal& signal) {
+  signal.fired->set_value();
+  return Success;
+}
+
+}  // namespace
+
+TEST_CASE("Delayed synchronous and cancelled firings record no latencies") {
+  Net net = {{"t0", {{{"Pa", Success}}, {{"Pb", Success}}}},
+             {"t1", {{{"Pb", Success}}, {{"Pc", Success}}}}};
+  PetriNet app(net, "no_latencies", std::make_shared<TaskSystem>(1),
+               {{"Pa", Success}}, {{"Pd", Success}});
+  const auto fired = std::make_shared<std::promise<void>>();
+  app.registerCallback("t0", Signal{fired});
+  app.registerCallback("t1", [] { return Success; });
+  app.setDelay("t0", std::chrono::milliseconds(1));
+  app.setDelay("t1", std::chrono::hours(1));
+  auto result = std::async(std::launch::async, [&] { return fire(app); });
+  // t0 fires on the loop once its delay expired, t1 waits for its delay.
+  fired->get_future().wait();
+  while (app.getActiveTransitions() != std::vector<Transition>{"t1"}) {
+    std::this_thread::yield();
+  }
+  cancel(app);
+  CHECK(result.get() == Canceled);
+  for (const auto& t : app.getLatencies().transitions) {
+    CHECK(t.queueing.count() == 0);
+    CHECK(t.service.count() == 0);
+    CHECK(t.delivery.count() == 0);
+  }
+}
+
 const static Token ExternalState("ExternalState");
 CREATE_CUSTOM_TOKEN(CustomState);
 
@@ -0,0 +1,112 @@
+#include "timer_wheel.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+using namespace symmetri;
+
+namespace {
+
+// advances the wheel to `now` and returns the tags of the expired timers.
+std::vector<uint64_t> advance(TimerWheel& wheel, uint64_t now,
+                              std::vector<uint64_t>& fired) {
+  std::vector<TaskSystem::Task> expired;
+  wheel.advance(now, expired);
+  fired.clear();
+  for (auto& task : expired) {
+    task();
+  }
+  return fired;
+}
+
+}  // namespace
+
+TEST_CASE("Timers expire at their deadline, in order of their deadlines") {
+  TimerWheel wheel;
+  std::vector<uint64_t> fired;
+  for (uint64_t deadline : {300, 5, 70000, 5, 1, 20000000}) {
+    wheel.add(deadline, [&fired, deadline] { fired.push_back(deadline); });
+  }
+  CHECK(wheel.size() == 6);
+  CHECK(wheel.nextTick() == 1);
+
+  CHECK(advance(wheel, 4, fired) == std::vector<uint64_t>{1});
+  CHECK(advance(wheel, 5, fired) == std::vector<uint64_t>{5, 5});
+  CHECK(advance(wheel, 299, fired).empty());
+  CHECK(advance(wheel, 69999, fired) == std::vector<uint64_t>{300});
+  CHECK(advance(wheel, 70000, fired) == std::vector<uint64_t>{70000});
+  CHECK(advance(wheel, 19999999, fired).empty());
+  CHECK(advance(wheel, 20000000, fired) == std::vector<uint64_t>{20000000});
+  CHECK(wheel.size() == 0);
+  CHECK(wheel.nextTick() == UINT64_MAX);
+  CHECK(wheel.now() == 20000000);
+}
+
+TEST_CASE("Timers beyond the span of the wheel expire on time") {
+  TimerWheel wheel(12345);
+  std::vector<uint64_t> fired;
+  const uint64_t far = 12345 + (uint64_t(1) << 33) + 7;
+  wheel.add(far, [&fired, far] { fired.push_back(far); });
+  CHECK(advance(wheel, far - 1, fired).empty());
+  CHECK(advance(wheel, far, fired) == std::vector<uint64_t>{far});
+}
+
+TEST_CASE("Timers with a deadline that passed expire at the next tick") {
+  TimerWheel wheel(100);
+  std::vector<uint64_t> fired;
+  wheel.add(3, [&fired] { fired.push_back(3); });
+  CHECK(wheel.nextTick() == 101);
+  CHECK(advance(wheel, 101, fired) == std::vector<uint64_t>{3});
+}
+
+TEST_CASE("Cancelled timers do not expire") {
+  TimerWheel wheel;
+  std::vector<uint64_t> fired;
+  const auto a = wheel.add(10, [&fired] { fired.push_back(10); });
+  const auto b = wheel.add(1000, [&fired] { fired.push_back(1000); });
+  CHECK(wheel.cancel(b));
+  CHECK(!wheel.cancel(b));
+  CHECK(wheel.size() == 1);
+  CHECK(advance(wheel, 2000, fired) == std::vector<uint64_t>{10});
+  // an expired timer can not be cancelled, also not once its node is reused.
+  CHECK(!wheel.cancel(a));
+  const auto c = wheel.add(3000, [&fired] { fired.push_back(3000); });
+  CHECK(!wheel.cancel(a));
+  CHECK(wheel.cancel(c));
+  CHECK(advance(wheel, 4000, fired).empty());
+}
+
+TEST_CASE("Many random timers expire in order") {
+  TimerWheel wheel;
+  std::vector<uint64_t> fired;
+  std::mt19937_64 random(42);
+  std::uniform_int_distribution<uint64_t> delay(1, 1 << 26);
+  for (size_t i = 0; i < 10000; i++) {
+    const auto deadline = delay(random);
+    wheel.add(deadline, [&fired, deadline] { fired.push_back(deadline); });
+  }
+  std::vector<TaskSystem::Task> expired;
+  uint64_t now = 0;
+  std::vector<uint64_t> all;
+  while (wheel.size() > 0) {
+    now += 4099;
+    wheel.advance(now, expired);
+    for (auto& task : expired) {
+      task();
+    }
+    expired.clear();
+    for (auto deadline : fired) {
+      CHECK(deadline <= now);
+      CHECK(deadline > now - 4099);
+    }
+    all.insert(all.end(), fired.begin(), fired.end());
+    fired.clear();
+  }
+  CHECK(all.size() == 10000);
+  CHECK(std::is_sorted(all.begin(), all.end()));
+}
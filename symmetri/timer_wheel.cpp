@@ -0,0 +1,183 @@
+#include "timer_wheel.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "bits.h"
+
+namespace symmetri {
+
+namespace {
+
+/**
+ * @brief Finds the first set bit after `from` in a bitmap of 256 bits.
+ *
+ * @param bits
+ * @param from
+ * @return size_t the index of the bit, or 256 if there is none
+ */
+size_t nextSet(const std::array<uint64_t, 4>& bits, size_t from) noexcept {
+  for (size_t word = from / 64; word < bits.size(); word++) {
+    const auto mask =
+        word == from / 64 ? ~uint64_t(0) << (from % 64) : ~uint64_t(0);
+    if ((bits[word] & mask) != 0) {
+      return word * 64 + lowestBit(bits[word] & mask);
+    }
+  }
+  return bits.size() * 64;
+}
+
+}  // namespace
+
+TimerWheel::TimerWheel(uint64_t now) : now_(now), size_(0), free_(nil) {
+  heads_.fill(nil);
+  for (auto& level : occupied_) {
+    level.fill(0);
+  }
+}
+
+TimerWheel::Id TimerWheel::add(uint64_t deadline, TaskSystem::Task&& task) {
+  uint32_t node;
+  if (free_ != nil) {
+    node = free_;
+    free_ = nodes_[node].next;
+  } else {
+    node = static_cast<uint32_t>(nodes_.size());
+    nodes_.emplace_back();
+    tasks_.emplace_back();
+  }
+  tasks_[node] = std::move(task);
+  auto& n = nodes_[node];
+  n.deadline = std::max(deadline, now_ + 1);
+  place(node);
+  size_++;
+  return (uint64_t(n.generation) << 32) | node;
+}
+
+bool TimerWheel::cancel(Id id) noexcept {
+  const auto node = static_cast<uint32_t>(id);
+  if (node >= nodes_.size() ||
+      nodes_[node].generation != static_cast<uint32_t>(id >> 32) ||
+      nodes_[node].list == nil) {
+    return false;
+  }
+  unlink(node);
+  tasks_[node] = TaskSystem::Task();
+  auto& n = nodes_[node];
+  n.generation++;
+  n.next = free_;
+  free_ = node;
+  size_--;
+  return true;
+}
+
+void TimerWheel::advance(uint64_t now, std::vector<TaskSystem::Task>& expired) {
+  while (true) {
+    const auto next = nextTick();
+    if (next > now) {
+      now_ = std::max(now_, now);
+      return;
+    }
+    now_ = next;
+    // lists of higher levels cascade first, as their timers may fall into
+    // slots of lower levels that start at the same tick.
+    if (static_cast<uint32_t>(now_) == 0) {
+      cascade(levels * slots);
+    }
+    for (size_t level = levels - 1; level > 0; level--) {
+      if ((now_ & ((uint64_t(1) << (slot_bits * level)) - 1)) == 0) {
+        cascade(level * slots + ((now_ >> (slot_bits * level)) & (slots - 1)));
+      }
+    }
+
+    // the timers of a slot of level 0 share their deadline; the list is in
+    // reverse order of adding.
+    const auto list = now_ & (slots - 1);
+    due_.clear();
+    for (auto node = heads_[list]; node != nil; node = nodes_[node].next) {
+      due_.push_back(node);
+    }
+    heads_[list] = nil;
+    occupied_[0][list / 64] &= ~(uint64_t(1) << (list % 64));
+    for (auto it = due_.rbegin(); it != due_.rend(); ++it) {
+      expired.push_back(std::move(tasks_[*it]));
+      auto& n = nodes_[*it];
+      n.list = nil;
+      n.generation++;
+      n.next = free_;
+      free_ = *it;
+    }
+    size_ -= due_.size();
+  }
+}
+
+uint64_t TimerWheel::nextTick() const noexcept {
+  for (size_t level = 0; level < levels; level++) {
+    const auto shift = slot_bits * level;
+    const auto slot =
+        nextSet(occupied_[level], ((now_ >> shift) & (slots - 1)) + 1);
+    if (slot < slots) {
+      const auto span = shift + slot_bits;
+      return ((now_ >> span) << span) | (uint64_t(slot) << shift);
+    }
+  }
+  if (heads_[levels * slots] != nil) {
+    return ((now_ >> 32) + 1) << 32;
+  }
+  return std::numeric_limits<uint64_t>::max();
+}
+
+void TimerWheel::place(uint32_t node) noexcept {
+  auto& n = nodes_[node];
+  const auto differs = n.deadline ^ now_;
+  size_t level = 0;
+  while (level < levels && (differs >> (slot_bits * (level + 1))) != 0) {
+    level++;
+  }
+  if (level == levels) {
+    n.list = levels * slots;
+  } else {
+    const auto slot = (n.deadline >> (slot_bits * level)) & (slots - 1);
+    n.list = static_cast<uint32_t>(level * slots + slot);
+    occupied_[level][slot / 64] |= uint64_t(1) << (slot % 64);
+  }
+  n.prev = nil;
+  n.next = heads_[n.list];
+  if (n.next != nil) {
+    nodes_[n.next].prev = node;
+  }
+  heads_[n.list] = node;
+}
+
+void TimerWheel::unlink(uint32_t node) noexcept {
+  auto& n = nodes_[node];
+  if (n.prev != nil) {
+    nodes_[n.prev].next = n.next;
+  } else {
+    heads_[n.list] = n.next;
+    if (n.next == nil && n.list < levels * slots) {
+      const auto slot = n.list % slots;
+      occupied_[n.list / slots][slot / 64] &= ~(uint64_t(1) << (slot % 64));
+    }
+  }
+  if (n.next != nil) {
+    nodes_[n.next].prev = n.prev;
+  }
+  n.list = nil;
+}
+
+void TimerWheel::cascade(size_t list) noexcept {
+  auto node = heads_[list];
+  heads_[list] = nil;
+  if (list < levels * slots) {
+    const auto slot = list % slots;
+    occupied_[list / slots][slot / 64] &= ~(uint64_t(1) << (slot % 64));
+  }
+  while (node != nil) {
+    const auto next = nodes_[node].next;
+    place(node);
+    node = next;
+  }
+}
+
+}  // namespace symmetri
@@ -0,0 +1,125 @@
+#pragma once
+
+/** @file timer_wheel.h */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <limits>
+#include <vector>
+
+#include "symmetri/tasks.h"
+
+namespace symmetri {
+
+/**
+ * @brief TimerWheel is a hierarchical timer wheel. Time is counted in ticks.
+ * It has 4 levels of 256 slots; a slot of level k covers 256^k ticks. A timer
+ * is placed on the level of the highest byte in which its deadline differs
+ * from the current tick, so the wheel spans 2^32 ticks; timers that are
+ * further away wait in an overflow list. Adding and cancelling a timer are
+ * O(1): every slot is an intrusive list of timers, and timers are stored in a
+ * pool that is reused. When time reaches the start of a slot of a higher
+ * level, its timers cascade down, so every timer cascades at most 4 times. A
+ * bitmap per level finds the next non-empty slot, so advancing over idle time
+ * does not visit every tick.
+ *
+ * The wheel is not thread-safe; its owner has to serialize access.
+ *
+ */
+class TimerWheel {
+ public:
+  using Id = uint64_t;  ///< Identifies a timer; ids are never reused
+
+  /**
+   * @brief Construct a new TimerWheel.
+   *
+   * @param now the current tick
+   */
+  explicit TimerWheel(uint64_t now = 0);
+
+  /**
+   * @brief Adds a timer.
+   *
+   * @param deadline the tick at which the timer expires. A deadline that has
+   * passed expires at the next tick.
+   * @param task runs when the timer expires
+   * @return Id
+   */
+  Id add(uint64_t deadline, TaskSystem::Task&& task);
+
+  /**
+   * @brief Removes a timer that has not expired.
+   *
+   * @param id
+   * @return true if the timer was removed
+   * @return false if it expired, was cancelled or never existed
+   */
+  bool cancel(Id id) noexcept;
+
+  /**
+   * @brief Advances the wheel up to and including tick `now`, and appends the
+   * tasks of the timers that expire to `expired`, in the order of their
+   * deadlines.
+   *
+   * @param now
+   * @param expired
+   */
+  void advance(uint64_t now, std::vector<TaskSystem::Task>& expired);
+
+  /**
+   * @brief Gets the next tick at which advance has work to do: a timer may
+   * expire, or timers have to cascade.
+   *
+   * @return uint64_t the tick, or the maximum uint64_t if there are no timers
+   */
+  uint64_t nextTick() const noexcept;
+
+  /**
+   * @brief Gets the tick up to which the wheel has advanced.
+   *
+   * @return uint64_t
+   */
+  uint64_t now() const noexcept { return now_; }
+
+  /**
+   * @brief Gets the amount of pending timers.
+   *
+   * @return size_t
+   */
+  size_t size() const noexcept { return size_; }
+
+ private:
+  static constexpr size_t levels = 4;              ///< The amount of levels
+  static constexpr size_t slot_bits = 8;           ///< log2 of the slots
+  static constexpr size_t slots = 1 << slot_bits;  ///< The slots per level
+  static constexpr uint32_t nil =
+      std::numeric_limits<uint32_t>::max();  ///< The end of a list
+
+  struct Node {
+    uint64_t deadline = 0;    ///< The tick of expiry
+    uint32_t generation = 0;  ///< Tells ids of reused nodes apart
+    uint32_t prev = nil;      ///< The previous timer in the slot
+    uint32_t next = nil;      ///< The next timer in the slot, or free node
+    uint32_t list = nil;      ///< The list it is in, as index of heads_
+  };
+
+  void place(uint32_t node) noexcept;
+  void unlink(uint32_t node) noexcept;
+  void cascade(size_t list) noexcept;
+
+  uint64_t now_;             ///< The last tick that was processed
+  size_t size_;              ///< The amount of pending timers
+  std::vector<Node> nodes_;  ///< The pool of timers
+  std::vector<TaskSystem::Task>
+      tasks_;  ///< The task of every node; apart, so cascades touch less memory
+  uint32_t free_;            ///< The first unused node
+  std::array<uint32_t, levels * slots + 1>
+      heads_;  ///< The first timer, by slot; the last is the overflow list
+  std::array<std::array<uint64_t, slots / 64>, levels>
+      occupied_;               ///< A bit per non-empty slot, by level
+  std::vector<uint32_t> due_;  ///< Reused to expire timers in order
+};
+
+}  // namespace symmetri
@@ -0,0 +1,58 @@
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <string>
+
+#include "symmetri/parsers.h"
+
+// Compiles PNML- or GRML-files into a header with a constexpr
+// symmetri::StaticNet. Usage:
+//
+//   symmetri_net_compiler <header> <name> <file>...
+//
+// The header is only rewritten if its contents change, so targets that include
+// it are not rebuilt needlessly.
+int main(int argc, char* argv[]) {
+  if (argc < 4) {
+    std::cerr << "usage: " << argv[0] << " <header> <name> <file>...\n";
+    return 1;
+  }
+  const std::filesystem::path header = argv[1];
+  const std::string name = argv[2];
+  const std::set<std::string> files(argv + 3, argv + argc);
+
+  std::string contents;
+  try {
+    if (std::filesystem::path(argv[3]).extension() == ".pnml") {
+      const auto [net, m0, max_in_flight, capacities] =
+          symmetri::readPnmlWithBounds(files);
+      contents = symmetri::writeStaticNet(net, m0, {}, name, max_in_flight,
+                                          capacities);
+    } else {
+      const auto [net, m0, priorities, max_in_flight, capacities] =
+          symmetri::readGrmlWithBounds(files);
+      contents = symmetri::writeStaticNet(net, m0, priorities, name,
+                                          max_in_flight, capacities);
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "could not compile " << argv[3] << ": " << e.what() << "\n";
+    return 1;
+  }
+
+  std::ifstream previous(header);
+  if (previous &&
+      std::string(std::istreambuf_iterator<char>(previous), {}) == contents) {
+    return 0;
+  }
+  previous.close();
+
+  if (header.has_parent_path()) {
+    std::filesystem::create_directories(header.parent_path());
+  }
+  std::ofstream out(header);
+  out << contents;
+  return out ? 0 : 1;
+}